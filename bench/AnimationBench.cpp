@@ -0,0 +1,289 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Animation/AnimationSystem.hpp"
+#include "Animation/Clip.hpp"
+#include "Animation/CpuSkinning.hpp"
+#include "Animation/IK.hpp"
+#include "Animation/Skeleton.hpp"
+#include "Animation/SkinnedMesh.hpp"
+#include "Bench.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Geometry/Mesh.hpp"
+
+namespace gk::bench {
+
+namespace {
+
+// A spine with two arms and two legs of five bones each
+animation::Skeleton character() {
+  animation::Skeleton skeleton(glm::vec3(0.0f));
+  int spine = 0;
+  for (int i = 0; i < 3; ++i) {
+    spine = skeleton.addBone(glm::vec3(0.0f, 0.3f * float(i + 1), 0.0f), spine);
+  }
+  for (const glm::vec3 direction : {glm::vec3(1, 0, 0), glm::vec3(-1, 0, 0), glm::vec3(0.3, -1, 0),
+                                    glm::vec3(-0.3, -1, 0)}) {
+    int bone = direction.y < 0.0f ? 0 : spine;
+    glm::vec3 joint = direction.y < 0.0f ? glm::vec3(0.0f) : glm::vec3(0.0f, 0.9f, 0.0f);
+    for (int i = 0; i < 5; ++i) {
+      joint += 0.2f * direction;
+      bone = skeleton.addBone(joint, bone);
+    }
+  }
+  return skeleton;
+}
+
+// Every bone swings around its own axis with five keys
+animation::Clip swing(int nbBones) {
+  animation::Clip clip(2.0f, nbBones);
+  const std::array<float, 5> times = {0.0f, 0.5f, 1.0f, 1.5f, 2.0f};
+  for (int bone = 0; bone < nbBones; ++bone) {
+    const glm::vec3 axis = glm::normalize(glm::vec3(bone % 3, 1 + bone % 2, 1));
+    std::array<glm::quat, 5> rotations;
+    for (size_t k = 0; k < rotations.size(); ++k) {
+      rotations[k] = glm::angleAxis(glm::radians(20.0f * float(k % 3)), axis);
+    }
+    clip.setRotations(bone, times, rotations);
+  }
+  return clip;
+}
+
+// Vertices influenced by four neighbouring bones each, as a limb between two joints
+std::vector<animation::SkinnedMesh::Vertex> skinnedVertices(size_t count, int nbBones) {
+  std::vector<animation::SkinnedMesh::Vertex> vertices(count);
+  for (size_t v = 0; v < count; ++v) {
+    auto& vertex = vertices[v];
+    vertex.position = 0.01f * glm::vec3(float(v % 97), float(v % 89), float(v % 83));
+    vertex.normal = glm::normalize(vertex.position + glm::vec3(0.1f));
+    vertex.uv = glm::vec2(0.0f);
+    vertex.boneCount = 4;
+    for (int i = 0; i < 4; ++i) {
+      vertex.boneIdx[i] = int((v + size_t(i)) % size_t(nbBones));
+    }
+    vertex.boneWeights = glm::vec4(0.4f, 0.3f, 0.2f, 0.1f);
+  }
+  return vertices;
+}
+
+}  // namespace
+
+void animationSystem() {
+  const animation::Skeleton base = character();
+  const animation::Clip clip = swing(base.size());
+  const unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+
+  for (unsigned int threads : {1u, hardware}) {
+    core::ThreadPool pool(threads);
+    for (size_t count : {1u, 10u, 100u, 1000u, 10000u}) {
+      std::vector<animation::Skeleton> skeletons(count, base);
+      animation::AnimationSystem system(pool);
+      for (size_t i = 0; i < count; ++i) {
+        // spread the instances over the clip so that they do not sample the same keys
+        system.setTime(system.add(skeletons[i], clip), 2.0f * float(i) / float(count));
+      }
+      const double seconds = measure([&] {
+        system.update(1.0f / 60.0f);
+        doNotOptimize(system.palettes().data());
+      });
+      const std::string name = "update, " + std::to_string(count) + " x " +
+                               std::to_string(base.size()) + " bones, " +
+                               std::to_string(threads) + " threads";
+      report(name, seconds, double(count), "skeletons");
+    }
+    if (hardware == 1) break;
+  }
+}
+
+void skinning() {
+  animation::Skeleton skeleton = character();
+  animation::Clip clip = swing(skeleton.size());
+  auto cursor = clip.cursor();
+  clip.sample(0.7f, cursor, skeleton);
+  const auto palette = skeleton.skinningMatrices();
+  const unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+  core::ThreadPool pool(hardware);
+
+  for (size_t count : {1000u, 100000u, 1000000u}) {
+    const auto vertices = skinnedVertices(count, skeleton.size());
+    std::vector<geometry::Mesh::Vertex> out(count);
+    const std::string suffix = std::to_string(count) + " vertices";
+
+    double seconds = measure([&] {
+      animation::skinVerticesScalar(vertices, palette, out);
+      doNotOptimize(out.data());
+    });
+    report("glm reference, " + suffix, seconds, double(count), "vertices");
+
+    seconds = measure([&] {
+      animation::skinVertices(vertices, palette, out);
+      doNotOptimize(out.data());
+    });
+    report("skinVertices, " + suffix, seconds, double(count), "vertices");
+
+    seconds = measure([&] {
+      animation::skinVertices(vertices, palette, out, pool);
+      doNotOptimize(out.data());
+    });
+    report("skinVertices, " + suffix + ", " + std::to_string(hardware) + " threads", seconds,
+           double(count), "vertices");
+  }
+}
+
+void ik() {
+  // bones of the limbs of character(), from the shoulder or hip to the hand or foot
+  constexpr std::array<int, 4> limbs = {4, 9, 14, 19};
+  constexpr int limbBones = 5;
+  constexpr size_t kTargets = 64;
+  animation::Skeleton skeleton = character();
+
+  // targets around the bind pose of each end effector. Some are out of reach of the two bone
+  // chains, which then stretch towards them.
+  std::array<std::vector<glm::vec3>, 4> targets;
+  for (size_t l = 0; l < limbs.size(); ++l) {
+    const glm::vec3 tip = skeleton.joint(limbs[l] + limbBones - 1);
+    for (size_t t = 0; t < kTargets; ++t) {
+      const float angle = glm::radians(float(t) * 360.0f / float(kTargets));
+      targets[l].push_back(tip + 0.3f * glm::vec3(std::cos(angle), std::sin(angle), 0.2f));
+    }
+  }
+
+  std::vector<animation::TwoBoneChain> twoBone(limbs.size());
+  std::vector<animation::IkChain> fabrik(limbs.size());
+  for (size_t l = 0; l < limbs.size(); ++l) {
+    twoBone[l] = {limbs[l] + limbBones - 2, limbs[l] + limbBones - 1, {}, glm::vec3(0, 0, 1)};
+    for (int b = 0; b < limbBones; ++b) {
+      fabrik[l].bones.push_back(limbs[l] + b);
+    }
+  }
+  auto aim = [&](size_t t) {
+    for (size_t l = 0; l < limbs.size(); ++l) {
+      twoBone[l].target = targets[l][t];
+      fabrik[l].target = targets[l][t];
+    }
+  };
+
+  // each call solves towards the next target, from the pose the previous one left
+  size_t t = 0;
+  double seconds = measure([&] {
+    aim(t++ % kTargets);
+    doNotOptimize(animation::solveTwoBone(skeleton, twoBone.front()));
+  });
+  report("two bone, one chain", seconds, 1.0, "chains");
+
+  seconds = measure([&] {
+    aim(t++ % kTargets);
+    doNotOptimize(animation::solveTwoBone(skeleton, std::span{twoBone}));
+  });
+  report("two bone, 4 chains", seconds, double(twoBone.size()), "chains");
+
+  const animation::IkSettings settings;
+  seconds = measure([&] {
+    aim(t++ % kTargets);
+    doNotOptimize(animation::solveFabrik(skeleton, fabrik.front(), settings));
+  });
+  report("fabrik, one chain of 5 bones", seconds, 1.0, "chains");
+
+  seconds = measure([&] {
+    aim(t++ % kTargets);
+    doNotOptimize(animation::solveFabrik(skeleton, std::span{fabrik}, settings));
+  });
+  report("fabrik, 4 chains of 5 bones", seconds, double(fabrik.size()), "chains");
+
+  // the chains of every target, shared by the crowd below
+  std::vector<std::vector<animation::TwoBoneChain>> twoBoneAt(kTargets, twoBone);
+  std::vector<std::vector<animation::IkChain>> fabrikAt(kTargets, fabrik);
+  for (size_t i = 0; i < kTargets; ++i) {
+    for (size_t l = 0; l < limbs.size(); ++l) {
+      twoBoneAt[i][l].target = targets[l][i];
+      fabrikAt[i][l].target = targets[l][i];
+    }
+  }
+
+  // a creature of many independent chains, the case of the pooled overloads
+  constexpr size_t kTentacles = 256;
+  animation::Skeleton creature(glm::vec3(0.0f));
+  std::vector<animation::TwoBoneChain> tentacles2(kTentacles);
+  std::vector<animation::IkChain> tentaclesN(kTentacles);
+  std::vector<glm::vec3> tips(kTentacles);
+  for (size_t c = 0; c < kTentacles; ++c) {
+    const float angle = glm::radians(float(c) * 360.0f / float(kTentacles));
+    const glm::vec3 direction(std::cos(angle), 0.0f, std::sin(angle));
+    int bone = 0;
+    for (int b = 0; b < limbBones; ++b) {
+      bone = creature.addBone(0.2f * float(b + 1) * direction, bone);
+      tentaclesN[c].bones.push_back(bone);
+    }
+    tentacles2[c] = {bone - 1, bone, {}, glm::vec3(0, 1, 0)};
+    tips[c] = creature.joint(bone);
+  }
+  auto aimTentacles = [&](size_t t) {
+    const float angle = glm::radians(float(t) * 360.0f / float(kTargets));
+    for (size_t c = 0; c < kTentacles; ++c) {
+      const glm::vec3 target = tips[c] + 0.3f * glm::vec3(std::cos(angle), std::sin(angle), 0.2f);
+      tentacles2[c].target = target;
+      tentaclesN[c].target = target;
+    }
+  };
+
+  const unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned int threads : {1u, hardware}) {
+    core::ThreadPool pool(threads);
+    const std::string suffix = ", " + std::to_string(threads) + " threads";
+
+    // a crowd, one character per task with its four limbs solved serially
+    constexpr size_t kCharacters = 1000;
+    std::vector<animation::Skeleton> crowd(kCharacters, skeleton);
+    seconds = measure([&] {
+      const size_t step = t++;
+      pool.parallelFor(crowd.size(), 16, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+          animation::solveTwoBone(crowd[c], std::span{twoBoneAt[(step + c) % kTargets]});
+        }
+      });
+      doNotOptimize(crowd.data());
+    });
+    report("two bone, 1000 characters x 4 chains" + suffix, seconds,
+           double(kCharacters * limbs.size()), "chains");
+
+    seconds = measure([&] {
+      const size_t step = t++;
+      pool.parallelFor(crowd.size(), 16, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+          animation::solveFabrik(crowd[c], std::span{fabrikAt[(step + c) % kTargets]}, settings);
+        }
+      });
+      doNotOptimize(crowd.data());
+    });
+    report("fabrik, 1000 characters x 4 chains" + suffix, seconds,
+           double(kCharacters * limbs.size()), "chains");
+
+    seconds = measure([&] {
+      aimTentacles(t++ % kTargets);
+      doNotOptimize(animation::solveTwoBone(creature, std::span{tentacles2}, pool));
+    });
+    report("two bone pooled, 256 chains" + suffix, seconds, double(kTentacles), "chains");
+
+    seconds = measure([&] {
+      aimTentacles(t++ % kTargets);
+      doNotOptimize(animation::solveFabrik(creature, std::span{tentaclesN}, pool, settings));
+    });
+    report("fabrik pooled, 256 chains of 5 bones" + suffix, seconds, double(kTentacles),
+           "chains");
+    if (hardware == 1) break;
+  }
+}
+
+}  // namespace gk::bench
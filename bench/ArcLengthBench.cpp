@@ -0,0 +1,82 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+#include "Geometry/Curves.hpp"
+
+namespace gk::bench {
+
+namespace {
+
+constexpr size_t kLookups = 4096;
+
+// Distances in random order, so that the binary searches do not follow each other in the table
+std::vector<float> randomDistances(float length) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> distance(0.0f, length);
+  std::vector<float> distances(kLookups);
+  for (auto& d : distances) {
+    d = distance(rng);
+  }
+  return distances;
+}
+
+void tableLookups(size_t samples) {
+  // uneven spacing along a parabola, as a curve gives
+  std::vector<glm::vec3> points(samples + 1);
+  for (size_t i = 0; i < points.size(); ++i) {
+    const float t = float(i) / float(samples);
+    points[i] = glm::vec3(t, t * t, 0.0f);
+  }
+  geometry::ArcLengthTable table;
+  table.build(points);
+  const auto distances = randomDistances(table.length());
+
+  const double seconds = measure([&] {
+    for (float d : distances) {
+      doNotOptimize(table.parameter(d));
+    }
+  });
+  report("parameter(), " + std::to_string(samples) + " samples", seconds, kLookups, "lookups");
+}
+
+}  // namespace
+
+void arcLength() {
+  for (size_t samples : {64u, 1024u, 16384u}) {
+    tableLookups(samples);
+  }
+
+  geometry::Bezier<4> curve(glm::vec3(0.0f), glm::vec3(10.0f, 0.0f, 0.0f));
+  curve[1].y = 6.0f;
+  curve[2].y = -6.0f;
+
+  // writing a control point drops the table, the next lookup builds it again
+  double seconds = measure([&] {
+    curve[1].y = 6.0f;
+    doNotOptimize(curve.length());
+  });
+  report("table build, cubic", seconds, 1.0, "tables");
+
+  const auto distances = randomDistances(curve.length());
+  seconds = measure([&] {
+    for (float d : distances) {
+      doNotOptimize(curve.pointAtDistance(d));
+    }
+  });
+  report("pointAtDistance(), cubic", seconds, kLookups, "points");
+
+  // one sweep of the table instead of a search per point
+  seconds = measure([&] { doNotOptimize(curve.sampleEquidistant(kLookups).data()); });
+  report("sampleEquidistant(), cubic", seconds, kLookups, "points");
+}
+
+}  // namespace gk::bench
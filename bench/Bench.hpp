@@ -0,0 +1,57 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+
+namespace gk::bench {
+
+// Keeps the compiler from optimising away a value computed only to be measured
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static const volatile void* sink;
+  sink = &value;
+#endif
+}
+
+// Calls fn until minSeconds have passed, after one call to warm the caches up, and returns the
+// mean time of a call in seconds
+template <typename Fn>
+double measure(Fn&& fn, double minSeconds = 0.2) {
+  using Clock = std::chrono::steady_clock;
+  fn();
+  size_t calls = 0;
+  double elapsed = 0.0;
+  const auto start = Clock::now();
+  do {
+    fn();
+    ++calls;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  } while (elapsed < minSeconds);
+  return elapsed / double(calls);
+}
+
+// Prints the time of a call and the throughput of items processed by each call
+inline void report(std::string_view name, double seconds, double items, std::string_view unit) {
+  std::printf("  %-44.*s %12.2f us %12.3g %.*s/s\n", int(name.size()), name.data(), seconds * 1e6,
+              items / seconds, int(unit.size()), unit.data());
+}
+
+// One function per topic, each in its own file
+void animationSystem();
+void arcLength();
+void bezier();
+void ik();
+void sceneTraversal();
+void skinning();
+void tessellation();
+
+}  // namespace gk::bench
@@ -0,0 +1,182 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <array>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+#include "Geometry/Curves.hpp"
+#include "Geometry/Mesh.hpp"
+#include "Geometry/Surface.hpp"
+#include "Geometry/algorithm.hpp"
+
+namespace gk::bench {
+
+namespace {
+
+// The evaluation of the curves and surfaces before the batched kernel, kept to measure against
+namespace baseline {
+
+// de Casteljau copying the control points into a new vector at every call
+template <typename Iterator>
+glm::vec3 deCasteljau(float u, Iterator begin, Iterator end) {
+  auto beta = std::vector<glm::vec3>(begin, end);
+  const auto n = beta.size();
+  for (size_t i = 1; i < n; ++i) {
+    for (size_t j = 0; j < n - i; j++) {
+      beta[j] = beta[j] * (1.0f - u) + beta[j + 1] * u;
+    }
+  }
+  return beta[0];
+}
+
+// Bezier::evaluate and updateIndices, new buffers for every sampling
+template <size_t N>
+void evaluateCurve(const std::array<glm::vec3, N>& ctrlPoints, unsigned int nbPoints,
+                   std::vector<glm::vec3>& points, std::vector<unsigned int>& indices) {
+  points = std::vector<glm::vec3>();
+  points.reserve(nbPoints);
+  const float epsilon = 1.0f / float(nbPoints);
+  for (float u = 0.0f; u < 1.0f; u += epsilon) {
+    points.push_back(deCasteljau(u, ctrlPoints.begin(), ctrlPoints.end()));
+  }
+  indices = std::vector<unsigned int>();
+  indices.reserve(points.size() * 2);
+  for (size_t i = 0; i + 1 < points.size(); ++i) {
+    indices.push_back(i);
+    indices.push_back(i + 1);
+  }
+  indices.push_back(points.size() - 1);
+}
+
+// BezierSurface::evaluate, calculateIndices and calculateNormals. The mesh is started anew at
+// every call, the original appended to the previous tessellation.
+template <size_t M, size_t N>
+void evaluateSurface(const std::array<glm::vec3, M * N>& ctrlGrid, size_t edges,
+                     geometry::Mesh& mesh) {
+  mesh = {};
+  std::vector<glm::vec3> qPoints(M * edges, glm::vec3(0.0f));
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t j = 0; j < edges; ++j) {
+      const float v = float(j) / float(edges - 1);
+      qPoints[j * M + i] = deCasteljau(v, ctrlGrid.cbegin() + i * N, ctrlGrid.cbegin() + i * N + N);
+    }
+  }
+  for (size_t i = 0; i < qPoints.size() / M; ++i) {
+    for (size_t j = 0; j < edges; ++j) {
+      const float u = float(j) / float(edges - 1);
+      geometry::Mesh::Vertex vertex{};
+      vertex.position = deCasteljau(u, qPoints.cbegin() + i * M, qPoints.cbegin() + (i + 1) * M);
+      vertex.uv = glm::vec2(float(i) / float(edges), float(j) / float(edges));
+      mesh.vertices.push_back(vertex);
+    }
+  }
+
+  mesh.indices.reserve(edges * edges * 6);
+  for (unsigned int i = 0; i < edges - 1; ++i) {
+    for (unsigned int j = 0; j < edges - 1; ++j) {
+      const unsigned int e = edges;
+      mesh.indices.insert(mesh.indices.end(), {i * e + j, i * e + j + 1, i * e + j + e});
+      mesh.indices.insert(mesh.indices.end(), {i * e + j + 1, i * e + j + e, i * e + j + e + 1});
+    }
+  }
+
+  // face normals of the cells
+  for (size_t i = 0; i < edges - 1; i++) {
+    for (size_t j = 0; j < edges - 1; j++) {
+      const glm::vec3& p0 = mesh.vertices[i * edges + j].position;
+      const glm::vec3& p1 = mesh.vertices[i * edges + j + 1].position;
+      const glm::vec3& p2 = mesh.vertices[i * edges + j + edges].position;
+      const glm::vec3& p3 = mesh.vertices[i * edges + j + edges + 1].position;
+      const glm::vec3 v0 = p2 - p0;
+      const glm::vec3 v1 = p1 - p0;
+      const glm::vec3 v2 = p3 - p1;
+      if (i == edges - 2) {
+        const glm::vec3 v3 = p3 - p2;
+        mesh.vertices[(i + 1) * edges + j].normal += glm::normalize(glm::cross(v0, v3));
+        if (i == j) {
+          mesh.vertices[(i + 1) * edges + j + 1].normal += glm::normalize(glm::cross(v2, v3));
+        }
+      }
+      if (j == edges - 2) {
+        mesh.vertices[i * edges + j + 1].normal += glm::normalize(glm::cross(v2, v1));
+      }
+      mesh.vertices[i * edges + j].normal = glm::normalize(glm::cross(v0, v1));
+    }
+  }
+}
+
+}  // namespace baseline
+
+template <size_t N>
+void bezierOrder(unsigned int segments) {
+  geometry::Bezier<N> curve(glm::vec3(0.0f), glm::vec3(10.0f, 0.0f, 0.0f), segments);
+  std::array<glm::vec3, N> ctrlPoints;
+  for (size_t i = 0; i < N; ++i) {
+    ctrlPoints[i] = glm::vec3(10.0f * float(i) / float(N - 1), 0.0f, 0.0f);
+    if (i > 0 && i + 1 < N) ctrlPoints[i].y = (i % 2 ? 4.0f : -4.0f);
+    curve[i] = ctrlPoints[i];
+  }
+  const std::string suffix = "N=" + std::to_string(N) + " " + std::to_string(segments) + " seg";
+  const unsigned int nbPoints = 2 * segments;
+
+  double seconds = measure([&] {
+    curve.setNbSegments(segments);
+    doNotOptimize(curve.curve().data());
+  });
+  report("batched, " + suffix, seconds, nbPoints, "points");
+
+  // one allocating de Casteljau per point, the code before the batched kernel
+  std::vector<glm::vec3> points;
+  std::vector<unsigned int> indices;
+  seconds = measure([&] {
+    baseline::evaluateCurve(ctrlPoints, nbPoints, points, indices);
+    doNotOptimize(points.data());
+  });
+  report("baseline, " + suffix, seconds, nbPoints, "points");
+}
+
+// Retessellation of a bicubic patch, e.g. while editing its control points
+void surface(size_t edges) {
+  std::array<glm::vec3, 16> ctrlGrid;
+  for (size_t i = 0; i < 4; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      ctrlGrid[i * 4 + j] = glm::vec3(float(i), (i + j) % 2 ? 1.0f : -1.0f, float(j));
+    }
+  }
+  const std::string suffix = "bicubic surface, " + std::to_string(edges) + " edges";
+  const double vertices = double(edges * edges);
+
+  geometry::BezierSurface<4, 4> patch(std::array<glm::vec3, 16>(ctrlGrid), edges);
+  double seconds = measure([&] {
+    patch.setMeshEdges(edges);
+    doNotOptimize(patch.mesh().vertices.data());
+  });
+  report("batched, " + suffix, seconds, vertices, "vertices");
+
+  geometry::Mesh mesh;
+  seconds = measure([&] {
+    baseline::evaluateSurface<4, 4>(ctrlGrid, edges, mesh);
+    doNotOptimize(mesh.vertices.data());
+  });
+  report("baseline, " + suffix, seconds, vertices, "vertices");
+}
+
+}  // namespace
+
+void bezier() {
+  for (unsigned int segments : {32u, 512u, 8192u}) {
+    bezierOrder<4>(segments);
+    bezierOrder<8>(segments);
+  }
+  for (size_t edges : {16u, 100u, 400u}) {
+    surface(edges);
+  }
+}
+
+}  // namespace gk::bench
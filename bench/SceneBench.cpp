@@ -0,0 +1,197 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+#include "GFX/PointLight.hpp"
+#include "Rendering/Scene.hpp"
+#include "Rendering/SceneNodes.hpp"
+
+namespace gk::bench {
+
+namespace {
+
+using rendering::NodeHandle;
+using rendering::NodeType;
+
+// Tree of groups with eight children each, one child in four being a light
+std::vector<NodeHandle> buildTree(rendering::Scene& scene, size_t count) {
+  std::vector<NodeHandle> groups = {scene.root()};
+  std::vector<NodeHandle> leaves;
+  for (size_t i = 1; i < count; ++i) {
+    const NodeHandle parent = groups[(i - 1) / 8];
+    NodeHandle child;
+    if (i % 4 == 0) {
+      child = scene.addLight({glm::vec3(1.0f), 1.0f, 10.0f, 1.0f}, glm::vec3(0.0f));
+      leaves.push_back(child);
+    } else {
+      child = scene.addNode();
+      groups.push_back(child);
+    }
+    scene.connect(parent, child);
+  }
+  return leaves;
+}
+
+// The walk of the renderer: the type of a node is read from its handle and the node fetched
+// from the store of that type
+size_t walkTyped(rendering::Scene& scene, std::vector<NodeHandle>& stack) {
+  size_t lights = 0;
+  stack.assign(1, scene.root());
+  while (!stack.empty()) {
+    const NodeHandle handle = stack.back();
+    stack.pop_back();
+    const rendering::SceneNode* node = nullptr;
+    if (handle.type == NodeType::eLight) {
+      node = scene.get<rendering::LightNode>(handle);
+      ++lights;
+    } else {
+      node = scene.get<rendering::SceneNode>(handle);
+    }
+    if (!node) continue;
+    stack.insert(stack.end(), node->children().begin(), node->children().end());
+  }
+  return lights;
+}
+
+// The scene graph of the baseline: nodes owned by a map of ids, linked by raw pointers and typed
+// by a virtual nodeType()
+namespace baseline {
+
+class Node {
+ public:
+  virtual ~Node() = default;
+  virtual NodeType nodeType() const { return NodeType::eGeneric; }
+  std::vector<Node*> children;
+};
+
+class Light : public Node {
+ public:
+  NodeType nodeType() const override { return NodeType::eLight; }
+  gfx::PointLight light{glm::vec3(1.0f), 1.0f, 10.0f, 1.0f};
+};
+
+struct Scene {
+  std::map<long, std::unique_ptr<Node>> nodes;
+  Node* root = nullptr;
+};
+
+// Same shape as buildTree
+void buildTree(Scene& scene, size_t count) {
+  std::vector<Node*> groups;
+  auto root = std::make_unique<Node>();
+  scene.root = root.get();
+  groups.push_back(root.get());
+  scene.nodes[0] = std::move(root);
+  for (size_t i = 1; i < count; ++i) {
+    Node* parent = groups[(i - 1) / 8];
+    std::unique_ptr<Node> child;
+    if (i % 4 == 0) {
+      child = std::make_unique<Light>();
+    } else {
+      child = std::make_unique<Node>();
+      groups.push_back(child.get());
+    }
+    parent->children.push_back(child.get());
+    scene.nodes[long(i)] = std::move(child);
+  }
+}
+
+std::vector<const Light*> getLights(const Node* node) {
+  std::vector<const Light*> lights;
+  for (const Node* child : node->children) {
+    if (child->nodeType() == NodeType::eLight) {
+      lights.push_back(dynamic_cast<const Light*>(child));
+    }
+  }
+  return lights;
+}
+
+// The recursion of the baseline renderer without the draw calls: every group gathers the lights
+// of its children with a dynamic_cast each and passes the lights in scope down by value
+size_t renderNode(const Node* node, std::vector<const Light*> lights) {
+  size_t visited = 0;
+  switch (node->nodeType()) {
+    case NodeType::eGeneric: {
+      auto groupLights = getLights(node);
+      lights.insert(lights.end(), groupLights.begin(), groupLights.end());
+      for (const Node* child : node->children) {
+        visited += renderNode(child, lights);
+      }
+      return visited + lights.size();
+    }
+    default:
+      return 1;
+  }
+}
+
+}  // namespace baseline
+
+// The slot map scene walked as before the typed handles, a lookup of any node then a cast to the
+// type wanted. It only isolates the lookup and the cast, the baseline graph is baseline::Scene
+size_t walkCast(rendering::Scene& scene, std::vector<NodeHandle>& stack) {
+  size_t lights = 0;
+  stack.assign(1, scene.root());
+  while (!stack.empty()) {
+    const NodeHandle handle = stack.back();
+    stack.pop_back();
+    auto node = scene.getNode(handle);
+    if (!node) continue;
+    if (dynamic_cast<rendering::LightNode*>(*node)) ++lights;
+    stack.insert(stack.end(), (*node)->children().begin(), (*node)->children().end());
+  }
+  return lights;
+}
+
+}  // namespace
+
+void sceneTraversal() {
+  for (size_t count : {10000u, 100000u}) {
+    rendering::Scene scene;
+    const auto leaves = buildTree(scene, count);
+    std::vector<NodeHandle> stack;
+    const std::string suffix = std::to_string(count) + " nodes";
+
+    double seconds = measure([&] { doNotOptimize(walkTyped(scene, stack)); });
+    report("typed handles, " + suffix, seconds, double(count), "nodes");
+
+    seconds = measure([&] { doNotOptimize(walkCast(scene, stack)); });
+    report("getNode and dynamic_cast, " + suffix, seconds, double(count), "nodes");
+
+    baseline::Scene original;
+    baseline::buildTree(original, count);
+    seconds = measure([&] { doNotOptimize(baseline::renderNode(original.root, {})); });
+    report("baseline pointer tree, " + suffix, seconds, double(count), "nodes");
+
+    // a moved root changes every world transform
+    auto root = scene.get<rendering::SceneNode>(scene.root());
+    seconds = measure([&] {
+      root->translate(glm::vec3(0.001f, 0.0f, 0.0f));
+      scene.updateTransforms();
+    });
+    report("updateTransforms, moved root, " + suffix, seconds, double(count), "nodes");
+
+    // an edit of the graph compiles the draw list again on the next request
+    const NodeHandle extra = scene.addNode();
+    bool connected = false;
+    seconds = measure([&] {
+      if (connected) {
+        scene.disconnect(leaves.front(), extra);
+      } else {
+        scene.connect(leaves.front(), extra);
+      }
+      connected = !connected;
+      doNotOptimize(scene.drawList().data());
+    });
+    report("drawList after an edit, " + suffix, seconds, double(count), "nodes");
+  }
+}
+
+}  // namespace gk::bench
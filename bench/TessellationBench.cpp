@@ -0,0 +1,71 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <glm/glm.hpp>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Geometry/Mesh.hpp"
+#include "Geometry/Surface.hpp"
+
+namespace gk::bench {
+
+namespace {
+
+// Grid of bicubic patches with bumps, so that no two patches are the same
+std::vector<std::array<glm::vec3, 16>> patchGrid(size_t side) {
+  std::vector<std::array<glm::vec3, 16>> patches(side * side);
+  for (size_t p = 0; p < patches.size(); ++p) {
+    const glm::vec3 origin(float(p % side) * 3.0f, 0.0f, float(p / side) * 3.0f);
+    for (size_t i = 0; i < 4; ++i) {
+      for (size_t j = 0; j < 4; ++j) {
+        const float height = float((p + i * 4 + j) % 5) * 0.25f;
+        patches[p][i * 4 + j] = origin + glm::vec3(float(i), height, float(j));
+      }
+    }
+  }
+  return patches;
+}
+
+}  // namespace
+
+void tessellation() {
+  const auto patches = patchGrid(16);
+  const std::span<const std::array<glm::vec3, 16>> grids{patches};
+  // powers of two, then the whole machine
+  std::vector<unsigned int> threadCounts;
+  const unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned int threads = 1; threads < maxThreads; threads *= 2) {
+    threadCounts.push_back(threads);
+  }
+  threadCounts.push_back(maxThreads);
+
+  for (size_t edges : {16u, 64u}) {
+    const double vertices = double(patches.size() * edges * edges);
+    double serial = 0.0;
+    geometry::Mesh mesh;
+    for (unsigned int threads : threadCounts) {
+      core::ThreadPool pool(threads);
+      const double seconds = measure([&] {
+        geometry::tessellatePatches<4, 4>(grids, edges, mesh, pool);
+        doNotOptimize(mesh.vertices.data());
+      });
+      if (threads == 1) serial = seconds;
+      char name[64];
+      std::snprintf(name, sizeof(name), "%zu patches, %zu edges, %u threads (x%.2f)",
+                    patches.size(), edges, threads, serial / seconds);
+      report(name, seconds, vertices, "vertices");
+    }
+  }
+}
+
+}  // namespace gk::bench
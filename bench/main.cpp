@@ -0,0 +1,35 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <array>
+#include <cstdio>
+#include <string_view>
+#include <utility>
+
+#include "Bench.hpp"
+
+// Runs every benchmark, or the ones named on the command line. Build in Release for meaningful
+// numbers.
+int main(int argc, char** argv) {
+  const std::array<std::pair<std::string_view, void (*)()>, 7> benchmarks = {{
+      {"bezier", gk::bench::bezier},
+      {"arclength", gk::bench::arcLength},
+      {"tessellation", gk::bench::tessellation},
+      {"animation", gk::bench::animationSystem},
+      {"skinning", gk::bench::skinning},
+      {"ik", gk::bench::ik},
+      {"scene", gk::bench::sceneTraversal},
+  }};
+
+  for (const auto& [name, run] : benchmarks) {
+    bool selected = argc < 2;
+    for (int i = 1; i < argc; ++i) {
+      selected = selected || name == argv[i];
+    }
+    if (!selected) continue;
+    std::printf("%.*s\n", int(name.size()), name.data());
+    run();
+  }
+  return 0;
+}
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <memory>
 
+#include "Animation/Clip.hpp"
 #include "Animation/Skeleton.hpp"
 #include "Animation/SkinnedMesh.hpp"
 #include "GFX/Enums.hpp"
@@ -134,21 +135,20 @@ class Application {
 
   void runMainLoop() {
     bool running = true;
-    float increment = .5f;
-    float angle = .0f;
+    auto clip = makeClip();
+    auto cursor = clip.cursor();
+    float time = 0.0f;
 
     while (running) {
       // input
       // -----
       processInput(running);
 
-      angle += increment;
-      if (angle == 120.f) {
-        increment = -.5f;
-      } else if (angle == 0.f) {
-        increment = .5f;
+      time += 1.0f / 60.0f;
+      if (time > clip.duration()) {
+        time -= clip.duration();
       }
-      m_skeleton->moveBone(2, increment, glm::vec3(0, 0, 1));
+      clip.sample(time, cursor, *m_skeleton);
       m_renderer->renderScene();
 
       m_window->update();
@@ -157,13 +157,26 @@ class Application {
 
  private:
   std::unique_ptr<gk::animation::Skeleton> makeSkeleton() {
-    auto skel = std::make_unique<gk::animation::Skeleton>(glm::mat4(1), glm::vec3(0, 0, 0));
-    int bone1 = skel->addBone(glm::mat4(1.f), glm::vec3(0.5, 0, 0), 0);
-    skel->addBone(glm::mat4(1.f), glm::vec3(1, 0, 0), bone1);
+    auto skel = std::make_unique<gk::animation::Skeleton>(glm::vec3(0, 0, 0));
+    int bone1 = skel->addBone(glm::vec3(0.5, 0, 0), 0);
+    skel->addBone(glm::vec3(1, 0, 0), bone1);
     m_skeleton = skel.get();
     return skel;
   }
 
+  // swings the last bone up to 120 degrees and back in 4 seconds
+  gk::animation::Clip makeClip() {
+    gk::animation::Clip clip(4.0f, m_skeleton->size());
+    const std::array<float, 5> times = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f};
+    const glm::vec3 axis(0, 0, 1);
+    const std::array<glm::quat, 5> rotations = {
+        glm::angleAxis(0.0f, axis), glm::angleAxis(glm::radians(60.0f), axis),
+        glm::angleAxis(glm::radians(120.0f), axis), glm::angleAxis(glm::radians(60.0f), axis),
+        glm::angleAxis(0.0f, axis)};
+    clip.setRotations(2, times, rotations);
+    return clip;
+  }
+
   std::unique_ptr<gk::animation::SkinnedMesh> makeCylinder(glm::vec3 base = glm::vec3(0, 0, 0),
                                                            glm::vec3 axis = glm::vec3(1, 0, 0),
                                                            float radius = .5f, float length = 3.,
@@ -223,25 +236,25 @@ class Application {
     scene.setActiveCamera(scene.addCamera(std::move(camera)));
 
     auto material = gk::gfx::createPhongMaterialAnimated(*m_ressourceManager);
-    long materialId = scene.addMaterial(std::move(material));
+    auto materialId = scene.addMaterial(std::move(material));
 
     auto cylinder = makeCylinder();
 
     auto copper = std::make_unique<gk::gfx::PhongMaterialParamsAnimated>(makeSkeleton());
 
-    long copperId = scene.addMaterialParameter(std::move(copper));
+    auto copperId = scene.addMaterialParameter(std::move(copper));
 
     auto cylinderId = scene.addMesh(*cylinder, materialId);
 
     if (cylinderId.has_value()) {
-      scene.connect(scene.rootId(), *cylinderId);
+      scene.connect(scene.root(), *cylinderId);
       scene.connect(*cylinderId, materialId);
       scene.connect(*cylinderId, copperId);
     }
 
-    long light1 =
+    auto light1 =
         scene.addLight({glm::vec3(1.0, 1.0, 1.0), 1.0, 20.0, 1.0}, glm::vec3(0.0, 5.0, 5.0));
-    scene.connect(scene.rootId(), light1);
+    scene.connect(scene.root(), light1);
   }
 
   std::unique_ptr<gk::gui::SDLOpenGLWindow> m_window;
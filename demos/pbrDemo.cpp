@@ -151,12 +151,12 @@ class Application {
     // add camera
     gk::gfx::FlyingCamera camera{glm::vec3(0.0f, 2.0f, 8.0f), glm::vec3(0.0f, 1.0f, 0.0f)};
 
-    long cameraId = scene.addCamera(std::move(camera));
+    auto cameraId = scene.addCamera(std::move(camera));
 
     scene.setActiveCamera(cameraId);
 
     auto material = gk::gfx::createMetallicRoughnessMaterial(*m_ressourceManager);
-    long materialtId = scene.addMaterial(std::move(material));
+    auto materialtId = scene.addMaterial(std::move(material));
 
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -173,12 +173,12 @@ class Application {
     auto copper = std::make_unique<gk::gfx::MetallicRoughnessMaterialParams>(
         glm::vec4{0.7f, 0.1f, 0.8f, 1.f}, 0.4f, 0.4f);
 
-    long copperId = scene.addMaterialParameter(std::move(copper));
+    auto copperId = scene.addMaterialParameter(std::move(copper));
 
     auto surfaceId = scene.addMesh(surface.mesh(), materialtId);
 
     if (surfaceId.has_value()) {
-      scene.connect(scene.rootId(), *surfaceId);
+      scene.connect(scene.root(), *surfaceId);
       scene.connect(*surfaceId, materialtId);
       scene.connect(*surfaceId, copperId);
 
@@ -186,19 +186,19 @@ class Application {
 
       // if (wallTex) {
       //   auto img = *wallTex;
-      //   long texId = scene.addTexture(img.pixels, img.width, img.height);
+      //   auto texId = scene.addTexture(img.pixels, img.width, img.height);
       //   scene.connect(*surfaceId, texId);
       // }
     }
-    long light1 =
+    auto light1 =
         scene.addLight({glm::vec3(1.0, 1.0, 1.0), 1.0, 20.0, 5.0}, glm::vec3(-5.0, 5.0, 0.0));
-    long light2 =
+    auto light2 =
         scene.addLight({glm::vec3(1.0, 1.0, 1.0), 1.0, 20.0, 5.0}, glm::vec3(5.0, 5.0, 0.0));
-    long light3 =
+    auto light3 =
         scene.addLight({glm::vec3(1.0, 1.0, 1.0), 1.0, 20.0, 5.0}, glm::vec3(0.0, 5.0, 5.0));
-    scene.connect(scene.rootId(), light1);
-    scene.connect(scene.rootId(), light2);
-    scene.connect(scene.rootId(), light3);
+    scene.connect(scene.root(), light1);
+    scene.connect(scene.root(), light2);
+    scene.connect(scene.root(), light3);
   }
 
   std::unique_ptr<gk::gui::SDLOpenGLWindow> m_window;
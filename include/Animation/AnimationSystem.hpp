@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+#include "Animation/Clip.hpp"
+#include "Animation/Pose.hpp"
+#include "Animation/Retarget.hpp"
+#include "Animation/Skeleton.hpp"
+#include "Core/ThreadPool.hpp"
+
+namespace gk::animation {
+
+// Plays clips on many skeletons at once. Every instance is independent, so sampling and the
+// computation of the global transforms are spread over the threads of a pool, and the skinning
+// matrices of all instances are written in one contiguous palette.
+// Skeletons and clips are not owned and must outlive the system, skeletons must not get new bones
+// once added. An instance writes the pose of its skeleton from a worker thread, so a skeleton is
+// played by one instance only.
+class AnimationSystem {
+ public:
+  explicit AnimationSystem(core::ThreadPool& pool);
+
+  // Returns the index of the new instance, throws std::invalid_argument if the skeleton is
+  // already played by another instance
+  size_t add(Skeleton& skeleton, const Clip& clip, float speed = 1.0f, bool loop = true);
+  // Plays clips made for the source skeleton of retarget on skeleton, its target. The map is not
+  // owned and must outlive the system.
+  size_t add(Skeleton& skeleton, const Clip& clip, const RetargetMap& retarget,
+             float speed = 1.0f, bool loop = true);
+  size_t size() const noexcept;
+
+  void setClip(size_t instance, const Clip& clip);
+  // Starts clip from its beginning and blends it in over duration seconds, after which it
+  // replaces the current clip
+  void crossFade(size_t instance, const Clip& clip, float duration);
+  void setTime(size_t instance, float time);
+  void setSpeed(size_t instance, float speed);
+
+  // Advances every instance by elapsed seconds, poses its skeleton and updates its palette
+  void update(float elapsed);
+
+  // Skinning matrices of an instance, as of the last update
+  std::span<const glm::mat4> palette(size_t instance) const;
+  // Skinning matrices of every instance, one after the other
+  std::span<const glm::mat4> palettes() const noexcept;
+
+ private:
+  struct Instance {
+    Skeleton* skeleton = nullptr;
+    const Clip* clip = nullptr;
+    Clip::Cursor cursor;
+    float time = 0.0f;
+    float speed = 1.0f;
+    bool loop = true;
+    size_t paletteOffset = 0;
+    size_t nbBones = 0;
+
+    // clip being faded in
+    const Clip* next = nullptr;
+    Clip::Cursor nextCursor;
+    float nextTime = 0.0f;
+    float fade = 0.0f;
+    float fadeDuration = 0.0f;
+    // pose of the clip being faded in, sized once so blending does not allocate
+    Pose nextPose;
+
+    // clips are sampled in sourcePose then retargeted to the pose of the skeleton
+    const RetargetMap* retarget = nullptr;
+    Pose sourcePose;
+  };
+
+  core::ThreadPool& m_pool;
+  std::vector<Instance> m_instances;
+  std::unordered_set<const Skeleton*> m_skeletons;
+  std::vector<glm::mat4> m_palettes;
+};
+
+}  // namespace gk::animation
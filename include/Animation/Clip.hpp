@@ -0,0 +1,74 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <span>
+#include <vector>
+
+#include "Animation/Pose.hpp"
+#include "Animation/Skeleton.hpp"
+
+namespace gk::animation {
+
+// Keyframed animation of the local pose of a skeleton.
+// Each bone has an optional translation, rotation and scale track, the keys of all tracks of a kind
+// are packed in one array. Rotations are stored as 16 bits normalised integers per component and
+// interpolated with a normalised linear interpolation. Bones without a track keep their pose.
+class Clip {
+ public:
+  // Position of a playback in every track, so that sampling with increasing times only moves
+  // forward from the previous keys instead of searching them
+  struct Cursor {
+    std::vector<uint32_t> keys;
+    float time = 0.0f;
+  };
+
+  Clip(float duration, int nbBones);
+
+  float duration() const noexcept;
+  int nbBones() const noexcept;
+
+  // Replace the track of a bone, times must be increasing and have as many entries as values
+  void setTranslations(int bone, std::span<const float> times,
+                       std::span<const glm::vec3> translations);
+  void setRotations(int bone, std::span<const float> times, std::span<const glm::quat> rotations);
+  void setScales(int bone, std::span<const float> times, std::span<const glm::vec3> scales);
+
+  Cursor cursor() const;
+  // Writes the pose at time, clamped to [0, duration], in the tracks of pose.
+  // Going back in time rewinds the cursor, a cursor made for another clip is reset.
+  void sample(float time, Cursor& cursor, Pose& pose) const;
+  void sample(float time, Cursor& cursor, Skeleton& skeleton) const;
+
+ private:
+  using PackedQuat = std::array<int16_t, 4>;
+
+  struct Track {
+    uint32_t first = 0;
+    uint32_t count = 0;
+  };
+
+  // Keys of every track of one kind
+  template <typename T>
+  struct Channel {
+    std::vector<Track> tracks;
+    std::vector<float> times;
+    std::vector<T> values;
+
+    void set(int bone, std::span<const float> times, std::span<const T> values);
+  };
+
+  float m_duration;
+  int m_nbBones;
+  Channel<glm::vec3> m_translations;
+  Channel<PackedQuat> m_rotations;
+  Channel<glm::vec3> m_scales;
+};
+
+}  // namespace gk::animation
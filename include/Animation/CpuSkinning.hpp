@@ -0,0 +1,34 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <span>
+
+#include "Animation/SkinnedMesh.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Geometry/Mesh.hpp"
+
+namespace gk::animation {
+
+// Linear blend skinning on the CPU, for software renderers where vertex shader skinning is the
+// bottleneck. The skinned vertices can be streamed to a mesh drawn with the plain mesh program.
+//
+// On x86 the kernel uses AVX2 and FMA when the CPU supports them, checked at run time, and SSE2
+// otherwise. Other architectures use plain glm. Bones outside of the palette are ignored and a
+// vertex without any valid influence keeps its bind position and normal. SkinnedMesh has no
+// tangents, the tangents written are a placeholder along x. out must hold at least as many
+// vertices as vertices.
+void skinVertices(std::span<const SkinnedMesh::Vertex> vertices,
+                  std::span<const glm::mat4> palette, std::span<geometry::Mesh::Vertex> out);
+// Same as above, split in chunks of vertices over the threads of the pool
+void skinVertices(std::span<const SkinnedMesh::Vertex> vertices,
+                  std::span<const glm::mat4> palette, std::span<geometry::Mesh::Vertex> out,
+                  core::ThreadPool& pool);
+// Same as above with plain glm on every architecture, the reference of the vectorised kernels
+void skinVerticesScalar(std::span<const SkinnedMesh::Vertex> vertices,
+                        std::span<const glm::mat4> palette, std::span<geometry::Mesh::Vertex> out);
+
+}  // namespace gk::animation
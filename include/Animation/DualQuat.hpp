@@ -0,0 +1,27 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <span>
+
+namespace gk::animation {
+
+// Rigid transform as a unit dual quaternion, real + epsilon dual. The real part is the rotation,
+// the dual part is half the translation times the rotation.
+struct DualQuat {
+  glm::quat real{1.0f, 0.0f, 0.0f, 0.0f};
+  glm::quat dual{0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+// Scale and shear are dropped, only the rotation and translation of the matrix are kept
+DualQuat toDualQuat(const glm::mat4& transform);
+// Converts every matrix of transforms, out must be at least as large
+void toDualQuats(std::span<const glm::mat4> transforms, std::span<DualQuat> out);
+
+glm::vec3 transformPoint(const DualQuat& dq, const glm::vec3& point);
+
+}  // namespace gk::animation
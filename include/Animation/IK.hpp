@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+#include "Animation/Skeleton.hpp"
+#include "Core/ThreadPool.hpp"
+
+namespace gk::animation {
+
+// Inverse kinematics on the bones of a Skeleton. A bone is the segment from its pivot to its joint,
+// the solvers move the joints of a chain and write the matching local rotations back in the pose.
+// Translations and scales are left untouched, scales along a chain are expected to be uniform.
+//
+// Targets are in model space. The batched overloads solve every chain from the same starting pose,
+// so chains of a batch must not share bones nor be ancestors of one another (e.g. the legs and the
+// arms of a character). The pooled overloads spread the chains over the threads of the pool.
+
+// Analytic solver for two bones, e.g. a leg for foot placement
+struct TwoBoneChain {
+  int upper;
+  // child of upper, its joint is the end effector
+  int lower;
+  glm::vec3 target;
+  // point the middle joint bends towards, in model space
+  glm::vec3 pole;
+};
+
+// Chain of any length for the iterative solver. A chain of a single bone aims it at the target,
+// which gives a look at constraint.
+struct IkChain {
+  static constexpr size_t kMaxBones = 32;
+
+  // from the root of the chain to the end effector, each bone is the parent of the next one
+  std::vector<int> bones;
+  glm::vec3 target;
+};
+
+// Fixed budget of the iterative solver, it stops earlier once the end effector is within
+// tolerance of the target
+struct IkSettings {
+  int iterations = 10;
+  float tolerance = 1e-3f;
+};
+
+// Returns true when the end effector reaches the target. Otherwise the target is out of reach and
+// the chain is stretched towards it, or the chain is invalid and the pose is left unchanged.
+bool solveTwoBone(Skeleton& skeleton, const TwoBoneChain& chain);
+// Returns the number of chains reaching their target
+size_t solveTwoBone(Skeleton& skeleton, std::span<const TwoBoneChain> chains);
+size_t solveTwoBone(Skeleton& skeleton, std::span<const TwoBoneChain> chains,
+                    core::ThreadPool& pool);
+
+// FABRIK, forward and backward reaching inverse kinematics
+bool solveFabrik(Skeleton& skeleton, const IkChain& chain, const IkSettings& settings = {});
+size_t solveFabrik(Skeleton& skeleton, std::span<const IkChain> chains,
+                   const IkSettings& settings = {});
+size_t solveFabrik(Skeleton& skeleton, std::span<const IkChain> chains, core::ThreadPool& pool,
+                   const IkSettings& settings = {});
+
+}  // namespace gk::animation
@@ -0,0 +1,44 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <span>
+#include <vector>
+
+namespace gk::animation {
+
+// Local transforms of every bone of a skeleton, relative to their parent, stored in structure of
+// arrays so the operations below run as straight loops over contiguous data
+struct Pose {
+  Pose() = default;
+  // Identity transforms for nbBones bones
+  explicit Pose(size_t nbBones);
+
+  // Only allocates when growing, new bones get identity transforms
+  void resize(size_t nbBones);
+  size_t size() const noexcept;
+
+  std::vector<glm::vec3> translations;
+  std::vector<glm::quat> rotations;
+  std::vector<glm::vec3> scales;
+};
+
+// The optional mask holds one weight per bone that scales weight, so that e.g. only the upper body
+// is blended. Poses must have the same number of bones, out is resized if needed and may be one
+// of the inputs.
+
+// Interpolates from a to b, weight 0 gives a and 1 gives b
+void blend(const Pose& a, const Pose& b, float weight, Pose& out,
+           std::span<const float> mask = {});
+// Applies the difference computed by makeAdditive on top of base
+void addAdditive(const Pose& base, const Pose& delta, float weight, Pose& out,
+                 std::span<const float> mask = {});
+// Difference between pose and reference, to be layered with addAdditive
+void makeAdditive(const Pose& pose, const Pose& reference, Pose& out);
+
+}  // namespace gk::animation
@@ -0,0 +1,62 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Animation/Pose.hpp"
+#include "Animation/Skeleton.hpp"
+
+namespace gk::animation {
+
+// Plays poses of a source skeleton on a target skeleton with another bone order or bind pose.
+// Everything that depends only on the two bind poses is computed once, applying the map is a
+// single loop over the target bones.
+//
+// A mapped bone keeps the rotation and scale it has relative to its bind pose, applied on top of
+// the bind pose of the target. Only the roots of the target take the translation of their source
+// bone, scaled by translationScale to account for characters of different sizes, other bones keep
+// the lengths of the target.
+class RetargetMap {
+ public:
+  RetargetMap() = default;
+  // sourceBones[t] is the source bone driving target bone t, or -1 to keep its bind pose. Throws
+  // std::invalid_argument if sourceBones does not have one entry per target bone and
+  // std::out_of_range if it references a bone outside of the source.
+  RetargetMap(const Skeleton& source, const Skeleton& target, std::span<const int> sourceBones,
+              float translationScale = 1.0f);
+
+  size_t sourceSize() const noexcept;
+  size_t targetSize() const noexcept;
+  // Starting pose for the source bones that clips do not animate
+  const Pose& sourceBindPose() const noexcept;
+
+  // source must have sourceSize() bones, out is resized to the target if needed
+  void apply(const Pose& source, Pose& out) const;
+
+ private:
+  Pose m_sourceBind;
+  // one entry per target bone
+  std::vector<int> m_sources;
+  // target bind rotation times the inverse of the source bind rotation
+  std::vector<glm::quat> m_rotationOffsets;
+  // target bind scale over source bind scale
+  std::vector<glm::vec3> m_scaleRatios;
+  std::vector<glm::vec3> m_sourceTranslations;
+  // translationScale for the roots, 0 for other bones
+  std::vector<float> m_translationWeights;
+  Pose m_targetBind;
+};
+
+// Source bone of every target bone with the same name, or -1
+std::vector<int> matchBones(std::span<const std::string> sourceNames,
+                            std::span<const std::string> targetNames);
+
+}  // namespace gk::animation
@@ -5,33 +5,84 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <span>
 #include <vector>
 
-namespace gk::animation {
+#include "Animation/DualQuat.hpp"
+#include "Animation/Pose.hpp"
 
-struct Bone {
-  glm::mat4 tr;
-  glm::vec3 joint;
-  int numChild;
-  int parent;
-  std::array<int, 4> children;
-};
+namespace gk::animation {
 
+// Bones are stored in structure of arrays, sorted so that a parent always comes before its
+// children. The pose is made of local transforms (translation, rotation, scale) relative to the
+// parent bone, global and skinning matrices are recomputed from it in a single forward pass when
+// they are requested after a change.
+//
+// The bind pose is the pose the mesh was modelled in, skinning matrices are the global transforms
+// times the inverse bind matrices, which bring a vertex from model space to the frame of its bone.
+//
+// Skeletons built joint by joint have a bind frame that is a translation to the pivot of each
+// bone, the joint of its parent, so a bone rotates around that joint. Imported skeletons are built
+// from their bind pose, and optionally the inverse bind matrices of the asset.
 class Skeleton {
  public:
-  Skeleton(const glm::mat4& tr, glm::vec3 joint);
-  const std::vector<Bone>& bones() const;
+  Skeleton(const glm::vec3& joint);
+  // Throws std::invalid_argument if a parent does not come before its child, or if the sizes of
+  // the bind pose or of the inverse bind matrices do not match. The inverse bind matrices are
+  // computed from the bind pose when none are given.
+  Skeleton(std::span<const int> parents, const Pose& bindPose,
+           std::span<const glm::mat4> inverseBindMatrices = {});
 
-  int addBone(const glm::mat4& tr, glm::vec3 joint, int parent);
+  // Returns the index of the new bone, or -1 if parent is not a bone of the skeleton
+  int addBone(const glm::vec3& joint, int parent);
+  // Rotates the bone by angle degrees around axis, expressed in the frame of the bone
   void moveBone(int index, float angle, const glm::vec3& axis);
 
-  Bone& operator[](int index);
+  void setTranslation(int index, const glm::vec3& translation);
+  void setRotation(int index, const glm::quat& rotation);
+  void setScale(int index, const glm::vec3& scale);
+
+  std::span<const int> parents() const noexcept;
+  const Pose& bindPose() const noexcept;
+  std::span<const glm::mat4> inverseBindMatrices() const noexcept;
+  // Joints of the bones in the bind pose. The joint of an imported bone is the origin of its
+  // first child, or its own origin for a leaf.
+  std::span<const glm::vec3> bindJoints() const noexcept;
+  const Pose& pose() const noexcept;
+  // Gives direct access to the local pose, e.g. to sample or blend animations into it.
+  // The number of bones must not change.
+  Pose& editPose();
+  void resetPose();
+
+  // Transforms from the frame of each bone to model space
+  std::span<const glm::mat4> globalTransforms();
+  // Transforms from the bind pose to the current pose, in model space
+  std::span<const glm::mat4> skinningMatrices();
+  // Skinning transforms as dual quaternions, converted from the matrices only when requested
+  std::span<const DualQuat> skinningDualQuats();
+  // Current position of the joint of a bone
+  glm::vec3 joint(int index);
 
   int size() const;
 
  private:
-  void propagateTransform(const glm::mat4& tr, Bone& bone);
-  std::vector<Bone> m_bones;
+  void update();
+
+  std::vector<int> m_parents;
+  // joints and bone origins in the bind pose
+  std::vector<glm::vec3> m_joints;
+  std::vector<glm::vec3> m_pivots;
+
+  Pose m_bindPose;
+  std::vector<glm::mat4> m_inverseBinds;
+  Pose m_pose;
+
+  std::vector<glm::mat4> m_globals;
+  std::vector<glm::mat4> m_skinning;
+  std::vector<DualQuat> m_skinningDualQuats;
+  bool m_needUpdate = true;
+  bool m_dualQuatsNeedUpdate = true;
 };
 
 }  // namespace gk::animation
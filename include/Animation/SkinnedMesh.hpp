@@ -4,9 +4,16 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
 #include <glm/glm.hpp>
+#include <span>
 #include <vector>
 
+#include "Geometry/Bounds.hpp"
+
 namespace gk::animation {
 
 
@@ -24,4 +31,46 @@ struct SkinnedMesh {
   std::vector<Vertex> vertices;
   std::vector<unsigned> indices;
 };
+
+// Skinned mesh with 8 bits bone indices and weights normalised on the unsigned Weight type
+// (uint8_t or uint16_t). Unused influences have a zero weight, so the bone count is implied.
+template <typename Weight>
+struct PackedSkinnedMesh {
+  static constexpr unsigned kMaxBones = 256;
+
+  struct Vertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 uv;
+    std::array<uint8_t, 4> boneIdx;
+    std::array<Weight, 4> boneWeights;
+  };
+
+  std::vector<Vertex> vertices;
+  std::vector<unsigned> indices;
+};
+
+using SkinnedMesh8 = PackedSkinnedMesh<uint8_t>;
+using SkinnedMesh16 = PackedSkinnedMesh<uint16_t>;
+
+// Vertices that could not be packed, by reason
+struct PackingReport {
+  // influence with a non zero weight on a bone outside of [0, 255]
+  std::vector<size_t> invalidBones;
+  // no influence with a positive weight
+  std::vector<size_t> noWeights;
+};
+
+// Weights are renormalised to sum to one and quantised so that the packed weights still sum
+// exactly to one. Fails with the list of offending vertices.
+template <typename Weight>
+std::expected<PackedSkinnedMesh<Weight>, PackingReport> pack(const SkinnedMesh& mesh);
+
+// Box holding the mesh posed by palette, given the box of its bind pose. A skinned vertex is a
+// weighted average of the vertex moved by each of its bones, so the union of the bind box moved
+// by every skinning matrix bounds it as long as the weights sum to one. Costs one box transform
+// per bone, cheap enough to call every frame. Returns bindBounds for an empty palette.
+geometry::AABB skinnedBounds(const geometry::AABB& bindBounds,
+                             std::span<const glm::mat4> palette) noexcept;
+
 }  // namespace gk::animation
@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace gk::core {
+
+// Reference to a value of a SlotMap. The generation tells apart the successive values stored in
+// the same slot, so a handle to an erased value stays invalid when the slot is reused.
+struct SlotHandle {
+  static constexpr uint32_t kInvalid = std::numeric_limits<uint32_t>::max();
+
+  uint32_t index = kInvalid;
+  uint32_t generation = 0;
+
+  friend bool operator==(const SlotHandle&, const SlotHandle&) = default;
+};
+
+// Values are kept contiguous in insertion order, erasing moves the last value in the hole.
+// Slots map handles to the position of their value, lookups are two array accesses.
+// Pointers and spans to values are invalidated by insertions and erasures, handles are not.
+template <typename T>
+class SlotMap {
+ public:
+  template <typename... Args>
+  SlotHandle emplace(Args&&... args);
+  // Returns false if the handle is stale
+  bool erase(SlotHandle handle);
+  void clear() noexcept;
+  void reserve(size_t capacity);
+
+  bool contains(SlotHandle handle) const noexcept;
+  // nullptr if the handle is stale
+  T* get(SlotHandle handle) noexcept;
+  const T* get(SlotHandle handle) const noexcept;
+
+  size_t size() const noexcept;
+  bool empty() const noexcept;
+  std::span<T> values() noexcept;
+  std::span<const T> values() const noexcept;
+  // Handle of values()[position]
+  SlotHandle handle(size_t position) const;
+
+ private:
+  struct Slot {
+    // position of the value, or next free slot when the slot is free
+    uint32_t position;
+    uint32_t generation;
+  };
+
+  std::vector<T> m_values;
+  // slot of every value
+  std::vector<uint32_t> m_owners;
+  std::vector<Slot> m_slots;
+  uint32_t m_freeHead = SlotHandle::kInvalid;
+};
+
+}  // namespace gk::core
+
+#include "SlotMap.tpp"
@@ -0,0 +1,112 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdexcept>
+#include <utility>
+
+namespace gk::core {
+
+template <typename T>
+template <typename... Args>
+SlotHandle SlotMap<T>::emplace(Args&&... args) {
+  uint32_t index = m_freeHead;
+  if (index == SlotHandle::kInvalid) {
+    index = uint32_t(m_slots.size());
+    m_slots.push_back({0, 0});
+  } else {
+    m_freeHead = m_slots[index].position;
+  }
+  m_values.emplace_back(std::forward<Args>(args)...);
+  m_owners.push_back(index);
+  m_slots[index].position = uint32_t(m_values.size() - 1);
+  return {index, m_slots[index].generation};
+}
+
+template <typename T>
+bool SlotMap<T>::erase(SlotHandle handle) {
+  if (!contains(handle)) return false;
+  Slot& slot = m_slots[handle.index];
+  const uint32_t position = slot.position;
+  const uint32_t last = uint32_t(m_values.size() - 1);
+  if (position != last) {
+    m_values[position] = std::move(m_values[last]);
+    m_owners[position] = m_owners[last];
+    m_slots[m_owners[position]].position = position;
+  }
+  m_values.pop_back();
+  m_owners.pop_back();
+
+  ++slot.generation;
+  slot.position = m_freeHead;
+  m_freeHead = handle.index;
+  return true;
+}
+
+template <typename T>
+void SlotMap<T>::clear() noexcept {
+  for (uint32_t position = 0; position < m_owners.size(); ++position) {
+    Slot& slot = m_slots[m_owners[position]];
+    ++slot.generation;
+    slot.position = m_freeHead;
+    m_freeHead = m_owners[position];
+  }
+  m_values.clear();
+  m_owners.clear();
+}
+
+template <typename T>
+void SlotMap<T>::reserve(size_t capacity) {
+  m_values.reserve(capacity);
+  m_owners.reserve(capacity);
+  m_slots.reserve(capacity);
+}
+
+template <typename T>
+bool SlotMap<T>::contains(SlotHandle handle) const noexcept {
+  // erasing bumps the generation, free slots never match a handle that was given out
+  return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+}
+
+template <typename T>
+T* SlotMap<T>::get(SlotHandle handle) noexcept {
+  return contains(handle) ? &m_values[m_slots[handle.index].position] : nullptr;
+}
+
+template <typename T>
+const T* SlotMap<T>::get(SlotHandle handle) const noexcept {
+  return contains(handle) ? &m_values[m_slots[handle.index].position] : nullptr;
+}
+
+template <typename T>
+size_t SlotMap<T>::size() const noexcept {
+  return m_values.size();
+}
+
+template <typename T>
+bool SlotMap<T>::empty() const noexcept {
+  return m_values.empty();
+}
+
+template <typename T>
+std::span<T> SlotMap<T>::values() noexcept {
+  return m_values;
+}
+
+template <typename T>
+std::span<const T> SlotMap<T>::values() const noexcept {
+  return m_values;
+}
+
+template <typename T>
+SlotHandle SlotMap<T>::handle(size_t position) const {
+  if (position >= m_owners.size()) {
+    throw std::out_of_range("Index out of range");
+  }
+  const uint32_t index = m_owners[position];
+  return {index, m_slots[index].generation};
+}
+
+}  // namespace gk::core
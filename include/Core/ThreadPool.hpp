@@ -0,0 +1,57 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace gk::core {
+
+// Fixed set of worker threads running data parallel loops.
+// Chunks of a loop are claimed from a shared atomic counter, so a worker that finishes early keeps
+// taking work from the slower ones.
+class ThreadPool {
+ public:
+  using Task = std::function<void(size_t begin, size_t end)>;
+
+  // threads is the total number of threads working on a loop, the calling thread included
+  explicit ThreadPool(unsigned int threads = std::thread::hardware_concurrency());
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  unsigned int size() const noexcept;
+
+  // Calls task on chunks of at most grain elements covering [0, count) and waits for all of them.
+  // The calling thread takes part in the work. Called from inside a task, the loop runs serially.
+  void parallelFor(size_t count, size_t grain, const Task& task);
+
+ private:
+  void workerLoop(std::stop_token stop);
+  void runChunks();
+
+  std::vector<std::jthread> m_workers;
+  std::mutex m_submitMutex;
+  std::mutex m_mutex;
+  std::condition_variable_any m_wake;
+  std::condition_variable m_done;
+
+  // loop being executed
+  const Task* m_task = nullptr;
+  size_t m_count = 0;
+  size_t m_grain = 1;
+  std::atomic<size_t> m_next = 0;
+  size_t m_activeWorkers = 0;
+  std::uint64_t m_generation = 0;
+};
+
+}  // namespace gk::core
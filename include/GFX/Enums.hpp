@@ -16,4 +16,7 @@ enum class TextureWrapping {
 
 enum class TextureFiltering { NEAREST, LINEAR };
 
+// How the vertices of a skinned mesh are blended between their bones
+enum class SkinningMode { eLinearBlend, eDualQuaternion };
+
 }  // namespace gk::gfx
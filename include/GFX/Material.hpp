@@ -13,6 +13,9 @@
 
 namespace gk::gfx {
 
+// Binding point of the storage block holding the bone palette in the skinning shaders
+inline constexpr GLuint kBonePaletteBinding = 0;
+
 class Material {
  public:
   Material(std::unique_ptr<gl::ShaderProgram>&& program);
@@ -33,7 +36,12 @@ inline Material createMaterial(io::RessourceManager& ressourceManager,
 Material createNormalMaterial(io::RessourceManager&);
 Material createParametricMaterial(io::RessourceManager&);
 Material createPhongMaterial(io::RessourceManager&);
+// Linear blend skinning
 Material createPhongMaterialAnimated(io::RessourceManager&);
+// Linear blend skinning of the packed SkinnedMesh8 and SkinnedMesh16 vertices
+Material createPhongMaterialAnimatedPacked(io::RessourceManager&);
+// Dual quaternion skinning, to use with SkinningMode::eDualQuaternion parameters
+Material createPhongMaterialDQS(io::RessourceManager&);
 Material createMetallicRoughnessMaterial(io::RessourceManager& ressourceManager);
 
 }  // namespace gk::gfx
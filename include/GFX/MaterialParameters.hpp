@@ -5,12 +5,14 @@
 #pragma once
 
 #include <glm/fwd.hpp>
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <memory>
 #include <span>
 #include <string>
 
 #include "Animation/Skeleton.hpp"
+#include "GFX/Enums.hpp"
 
 // TODO: refactor this and add textures here
 
@@ -42,7 +44,13 @@ class MaterialParameters {
   virtual std::span<const std::pair<std::string, glm::vec3>> vec3Parameters() const noexcept = 0;
   virtual std::span<const std::pair<std::string, glm::vec4>> vec4Parameters() const noexcept = 0;
   virtual std::span<const std::pair<std::string, glm::mat3>> mat3Parameters() const noexcept = 0;
-  virtual std::vector<std::pair<std::string, glm::mat4>> mat4Parameters() const noexcept = 0;
+  virtual std::span<const std::pair<std::string, glm::mat4>> mat4Parameters() const noexcept = 0;
+  // Content of the storage block at kBonePaletteBinding, written once per draw in a streamed
+  // buffer. Empty for materials without skinning.
+  virtual std::span<const std::byte> bonePalette() const noexcept = 0;
+  // Skinning matrices of the palette whatever the skinning mode, the scene bounds skinned meshes
+  // with them. Empty for materials without skinning.
+  virtual std::span<const glm::mat4> skinningMatrices() const noexcept = 0;
 };
 
 class MockParameters : public MaterialParameters {
@@ -69,7 +77,9 @@ class MockParameters : public MaterialParameters {
   std::span<const std::pair<std::string, glm::vec3>> vec3Parameters() const noexcept override;
   std::span<const std::pair<std::string, glm::vec4>> vec4Parameters() const noexcept override;
   std::span<const std::pair<std::string, glm::mat3>> mat3Parameters() const noexcept override;
-  std::vector<std::pair<std::string, glm::mat4>> mat4Parameters() const noexcept override;
+  std::span<const std::pair<std::string, glm::mat4>> mat4Parameters() const noexcept override;
+  std::span<const std::byte> bonePalette() const noexcept override;
+  std::span<const glm::mat4> skinningMatrices() const noexcept override;
 };
 
 class PhongMaterialParams : public MaterialParameters {
@@ -94,7 +104,9 @@ class PhongMaterialParams : public MaterialParameters {
   std::span<const std::pair<std::string, glm::vec3>> vec3Parameters() const noexcept override;
   std::span<const std::pair<std::string, glm::vec4>> vec4Parameters() const noexcept override;
   std::span<const std::pair<std::string, glm::mat3>> mat3Parameters() const noexcept override;
-  std::vector<std::pair<std::string, glm::mat4>> mat4Parameters() const noexcept override;
+  std::span<const std::pair<std::string, glm::mat4>> mat4Parameters() const noexcept override;
+  std::span<const std::byte> bonePalette() const noexcept override;
+  std::span<const glm::mat4> skinningMatrices() const noexcept override;
 
  private:
   std::array<std::pair<std::string, glm::vec3>, 3> m_vecParams;
@@ -103,16 +115,22 @@ class PhongMaterialParams : public MaterialParameters {
 
 class PhongMaterialParamsAnimated : public PhongMaterialParams {
  public:
-  PhongMaterialParamsAnimated(std::unique_ptr<animation::Skeleton>&& skeleton);
-  std::vector<std::pair<std::string, glm::mat4>> mat4Parameters() const noexcept override;
+  // The skinning mode must match the vertex shader of the material, the palette holds a mat4 per
+  // bone for linear blend skinning and a pair of quaternions for dual quaternion skinning
+  PhongMaterialParamsAnimated(std::unique_ptr<animation::Skeleton>&& skeleton,
+                              SkinningMode mode = SkinningMode::eLinearBlend);
   std::span<const std::pair<std::string, glm::int32>> intParameters() const noexcept override;
+  // Skinning transforms of the skeleton, updated when it changed since the last call
+  std::span<const std::byte> bonePalette() const noexcept override;
+  std::span<const glm::mat4> skinningMatrices() const noexcept override;
 
   animation::Skeleton& skeleton();
+  SkinningMode skinningMode() const noexcept;
 
  private:
   std::unique_ptr<animation::Skeleton> m_skel;
+  SkinningMode m_mode;
   std::pair<std::string, glm::int32> m_numBones;
-  std::vector<std::pair<std::string, glm::mat4>> m_bonesParams;
 };
 
 
@@ -45,24 +45,35 @@ inline std::tuple<int, GLenum, size_t> componentsTypeSize(GLenum type_enum) {
   }
 };
 
+// Streamed buffers are always respecified so the driver can orphan the storage still in use by
+// previous draws instead of waiting for them
 template <typename T>
 inline size_t updateBuffer(GLuint handle, const std::span<const T>& buffer, size_t old_buf_size,
-                           GLenum target) {
+                           GLenum target, GLenum usage = GL_STATIC_DRAW) {
   glBindBuffer(target, handle);
-  if (old_buf_size != buffer.size()) {
-    glBufferData(target, buffer.size() * sizeof(T), buffer.data(), GL_STATIC_DRAW);
+  if (old_buf_size != buffer.size() || usage == GL_STREAM_DRAW) {
+    glBufferData(target, buffer.size() * sizeof(T), buffer.data(), usage);
   } else {
     glBufferSubData(target, 0, buffer.size() * sizeof(T), buffer.data());
   }
   return buffer.size();
 }
 
+// Overwrites buffer.size() elements of the buffer object starting at the element offset
 template <typename T>
-void setupVertexObjects(GLuint& vao, GLuint& vbo, const std::span<const T>& v) {
+inline void updateBufferRange(GLuint handle, const std::span<const T>& buffer, size_t offset,
+                              GLenum target) {
+  glBindBuffer(target, handle);
+  glBufferSubData(target, offset * sizeof(T), buffer.size() * sizeof(T), buffer.data());
+}
+
+template <typename T>
+void setupVertexObjects(GLuint& vao, GLuint& vbo, const std::span<const T>& v,
+                        GLenum usage = GL_STATIC_DRAW) {
   glGenVertexArrays(1, &vao);
   glBindVertexArray(vao);
   glGenBuffers(1, &vbo);
-  updateBuffer(vbo, v, 0, GL_ARRAY_BUFFER);
+  updateBuffer(vbo, v, 0, GL_ARRAY_BUFFER, usage);
 }
 
 void setupElementObjects(GLuint& ebo, const std::span<const GLuint>& indices);
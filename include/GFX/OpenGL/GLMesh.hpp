@@ -13,6 +13,7 @@
 
 #include "GFX/OpenGL/GLHelperFn.hpp"
 #include "GFX/OpenGL/GLShaderProgram.hpp"
+#include "GFX/OpenGL/GLVertexAttribute.hpp"
 
 namespace gk::gfx::gl {
 
@@ -32,6 +33,9 @@ enum DrawingMode {
 
 enum BufferType { ARRAY = GL_ARRAY_BUFFER, ELEMENT = GL_ELEMENT_ARRAY_BUFFER };
 
+// How often the vertices are updated, STREAM for data rewritten every frame such as CPU skinning
+enum BufferUsage { STATIC = GL_STATIC_DRAW, DYNAMIC = GL_DYNAMIC_DRAW, STREAM = GL_STREAM_DRAW };
+
 class Mesh {
  public:
   template <typename V>
@@ -40,7 +44,14 @@ class Mesh {
 
   template <typename V>
   Mesh(const std::span<const V>& vertices, const std::span<const uint>& indices,
-         const ShaderProgram& program, DrawingMode drawingMode = TRIANGLES);
+         const ShaderProgram& program, DrawingMode drawingMode = TRIANGLES,
+         BufferUsage usage = STATIC);
+
+  // Vertices laid out as described by formats instead of the attributes of the program
+  template <typename V>
+  Mesh(const std::span<const V>& vertices, const std::span<const uint>& indices,
+       const ShaderProgram& program, std::span<const VertexFormat> formats,
+       DrawingMode drawingMode = TRIANGLES);
   Mesh() = delete;
   Mesh(const Mesh&) = delete;
   Mesh& operator=(const Mesh&) = delete;
@@ -52,6 +63,9 @@ class Mesh {
   void update(const std::span<const V>& vertices) noexcept;
   template <typename V>
   void update(const std::span<const V>& vertices, const std::span<const uint>& indices) noexcept;
+  // Uploads only the given vertices, starting at the vertex offset of the buffer
+  template <typename V>
+  void update(const std::span<const V>& vertices, size_t offset) noexcept;
 
   void setDrawingMode(const DrawingMode mode) noexcept;
   DrawingMode drawingMode() const noexcept;
@@ -64,6 +78,7 @@ class Mesh {
   size_t m_vertexBufferSize;
   DrawingMode m_drawingMode;
   BufferType m_bufferType;
+  BufferUsage m_usage = STATIC;
 };
 
 template <typename V>
@@ -75,13 +90,30 @@ Mesh::Mesh(const std::span<const V>& vertices, const ShaderProgram& program,
   m_vbo = 0;
   m_ebo = 0;
   setupVertexObjects(m_vao, m_vbo, vertices);
-  program.enableVertexAttributes();
+  program.enableVertexAttributes(sizeof(V));
+  m_vertexBufferSize = vertices.size();
+}
+
+template <typename V>
+Mesh::Mesh(const std::span<const V>& vertices, const std::span<const uint>& indices,
+               const ShaderProgram& program, DrawingMode drawingMode, BufferUsage usage)
+    : m_drawingMode(drawingMode), m_usage(usage) {
+  m_bufferType = ELEMENT;
+  m_vao = 0;
+  m_vbo = 0;
+  m_ebo = 0;
+  setupVertexObjects(m_vao, m_vbo, vertices, m_usage);
+  setupElementObjects(m_ebo, indices);
+  program.enableVertexAttributes(sizeof(V));
+
+  m_indexBufferSize = indices.size();
   m_vertexBufferSize = vertices.size();
 }
 
 template <typename V>
 Mesh::Mesh(const std::span<const V>& vertices, const std::span<const uint>& indices,
-               const ShaderProgram& program, DrawingMode drawingMode)
+           const ShaderProgram& program, std::span<const VertexFormat> formats,
+           DrawingMode drawingMode)
     : m_drawingMode(drawingMode) {
   m_bufferType = ELEMENT;
   m_vao = 0;
@@ -89,7 +121,7 @@ Mesh::Mesh(const std::span<const V>& vertices, const std::span<const uint>& indi
   m_ebo = 0;
   setupVertexObjects(m_vao, m_vbo, vertices);
   setupElementObjects(m_ebo, indices);
-  program.enableVertexAttributes();
+  program.enableVertexAttributes(formats, sizeof(V));
 
   m_indexBufferSize = indices.size();
   m_vertexBufferSize = vertices.size();
@@ -97,14 +129,23 @@ Mesh::Mesh(const std::span<const V>& vertices, const std::span<const uint>& indi
 
 template <typename V>
 void Mesh::update(const std::span<const V>& vertices) noexcept {
-  m_vertexBufferSize = updateBuffer(m_vbo, vertices, m_vertexBufferSize, GL_ARRAY_BUFFER);
+  m_vertexBufferSize =
+      updateBuffer(m_vbo, vertices, m_vertexBufferSize, GL_ARRAY_BUFFER, GLenum(m_usage));
 }
 
 template <typename V>
 void Mesh::update(const std::span<const V>& vertices,
                     const std::span<const uint>& indices) noexcept {
-  m_vertexBufferSize = updateBuffer(m_vbo, vertices, m_vertexBufferSize, GL_ARRAY_BUFFER);
+  m_vertexBufferSize =
+      updateBuffer(m_vbo, vertices, m_vertexBufferSize, GL_ARRAY_BUFFER, GLenum(m_usage));
   m_indexBufferSize = updateBuffer(m_ebo, indices, m_indexBufferSize, GL_ELEMENT_ARRAY_BUFFER);
 }
 
+template <typename V>
+void Mesh::update(const std::span<const V>& vertices, size_t offset) noexcept {
+  if (offset + vertices.size() <= m_vertexBufferSize) {
+    updateBufferRange(m_vbo, vertices, offset, GL_ARRAY_BUFFER);
+  }
+}
+
 }  // namespace gk::gfx::gl
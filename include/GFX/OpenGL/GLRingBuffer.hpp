@@ -0,0 +1,51 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <epoxy/gl.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace gk::gfx::gl {
+
+// Buffer persistently mapped for writing, split in one section per frame in flight so the CPU
+// writes the next frame while the GPU still reads the previous ones. Each section is fenced at the
+// end of its frame, and nextFrame() waits on that fence before the section is written again.
+class RingBuffer {
+ public:
+  struct Range {
+    GLintptr offset;
+    GLsizeiptr size;
+  };
+
+  // sectionSize is the number of bytes available per frame, it doubles when a frame needs more
+  RingBuffer(GLenum target, size_t sectionSize, size_t frames = 3);
+  ~RingBuffer();
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+
+  // Copies data to the section of the current frame, aligned for binding
+  Range write(std::span<const std::byte> data);
+  void bindRange(GLuint index, const Range& range) const noexcept;
+  // Call once all the draws reading the current section are issued
+  void nextFrame();
+
+ private:
+  void allocate(size_t sectionSize);
+  void release() noexcept;
+
+  GLenum m_target;
+  GLuint m_id = 0;
+  std::byte* m_data = nullptr;
+  size_t m_sectionSize = 0;
+  size_t m_alignment = 1;
+  size_t m_frame = 0;
+  size_t m_head = 0;
+  std::vector<GLsync> m_fences;
+};
+
+}  // namespace gk::gfx::gl
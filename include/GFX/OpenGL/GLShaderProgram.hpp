@@ -38,7 +38,12 @@ class ShaderProgram {
   void compileFile(const std::string& relativePath, io::RessourceManager& assetManager,
                    ShaderType type) const noexcept;
   void link() noexcept;
-  void enableVertexAttributes() const noexcept;
+  // stride is the size of the vertex type, it may hold members the program does not consume.
+  // Attributes are read with the component type the shader declares.
+  void enableVertexAttributes(GLsizei stride) const noexcept;
+  // Vertex layout given explicitly, e.g. for packed or normalised attributes
+  void enableVertexAttributes(std::span<const VertexFormat> formats,
+                              GLsizei stride) const noexcept;
 
   template <typename T>
   void setUniform(const std::string& name, const T& value) const noexcept;
@@ -6,6 +6,7 @@
 
 #include <epoxy/gl.h>
 
+#include <cstddef>
 #include <string>
 
 namespace gk::gfx::gl {
@@ -17,4 +18,18 @@ struct VertexAttribute {
   GLvoid* offset;
   GLint location;
 };
+
+// Storage of an attribute in a vertex buffer, for vertex types that do not store every attribute
+// as the type the shader reads it as
+struct VertexFormat {
+  GLuint location;
+  GLint size;
+  // component type in the buffer
+  GLenum type;
+  // integer components are converted to floats in [0, 1] or [-1, 1]
+  GLboolean normalized;
+  // the shader reads integers, the components are passed as is
+  bool integer;
+  size_t offset;
+};
 }  // namespace gk::gfx::gl
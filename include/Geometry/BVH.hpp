@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Geometry/Bounds.hpp"
+
+namespace gk::geometry {
+
+// Bounding volume hierarchy over boxes that move. A leaf is inserted next to the node that grows
+// the surface of the tree the least, and updating a leaf refits the boxes of its ancestors instead
+// of rebuilding the tree. Refitting rotates the nodes whose surface a rotation reduces, so the tree
+// stays balanced whatever the order of the insertions.
+class DynamicBVH {
+ public:
+  static constexpr uint32_t kNull = std::numeric_limits<uint32_t>::max();
+
+  // Returns the leaf, value is what queries report for it
+  uint32_t insert(const AABB& box, uint32_t value);
+  void remove(uint32_t leaf);
+  // Refitting stops at the first ancestor whose box does not change
+  void update(uint32_t leaf, const AABB& box);
+  void clear() noexcept;
+  void reserve(size_t leaves);
+
+  size_t size() const noexcept;
+  const AABB& bounds(uint32_t leaf) const;
+  uint32_t value(uint32_t leaf) const;
+
+  // Calls visit(value) for the leaves whose box intersects the frustum
+  template <typename Visit>
+  void query(const Frustum& frustum, Visit&& visit) const;
+
+ private:
+  struct Node {
+    AABB box;
+    uint32_t parent = kNull;
+    // both kNull for a leaf
+    uint32_t left = kNull;
+    uint32_t right = kNull;
+    uint32_t value = kNull;
+
+    bool leaf() const noexcept { return left == kNull; }
+  };
+
+  uint32_t allocate();
+  void release(uint32_t node) noexcept;
+  uint32_t findSibling(const AABB& box) const noexcept;
+  void refit(uint32_t node) noexcept;
+  void rotate(uint32_t node) noexcept;
+  const Node& leafNode(uint32_t leaf) const;
+
+  std::vector<Node> m_nodes;
+  uint32_t m_root = kNull;
+  // free nodes are chained through their parent
+  uint32_t m_free = kNull;
+  size_t m_leaves = 0;
+  // scratch of the queries, kept so that a query does not allocate
+  mutable std::vector<uint32_t> m_stack;
+};
+
+template <typename Visit>
+void DynamicBVH::query(const Frustum& frustum, Visit&& visit) const {
+  if (m_root == kNull) return;
+  m_stack.clear();
+  m_stack.push_back(m_root);
+  while (!m_stack.empty()) {
+    const Node& node = m_nodes[m_stack.back()];
+    m_stack.pop_back();
+    if (!frustum.intersects(node.box)) continue;
+    if (node.leaf()) {
+      visit(node.value);
+    } else {
+      m_stack.push_back(node.left);
+      m_stack.push_back(node.right);
+    }
+  }
+}
+
+}  // namespace gk::geometry
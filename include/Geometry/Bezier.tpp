@@ -4,10 +4,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <glm/glm.hpp>
 #include <glm/gtx/normal.hpp>
-#include <iterator>
+#include <span>
 #include <stdexcept>
 #include <vector>
 
@@ -43,12 +45,20 @@ unsigned int gk::geometry::Bezier<N>::nbSegments() {
 template <size_t N>
 void gk::geometry::Bezier<N>::setNbSegments(unsigned int nbSegments) {
   m_nbPoints = nbSegments * 2;
+  m_tolerance = 0.0f;
+  evaluate();
+}
+
+template <size_t N>
+void gk::geometry::Bezier<N>::setTolerance(float tolerance) {
+  m_tolerance = tolerance;
+  evaluate();
 }
 
 template <size_t N>
 const std::unique_ptr<gk::geometry::SimpleCurve> gk::geometry::Bezier<N>::ctrlCurve() {
   auto curve = std::make_unique<gk::geometry::SimpleCurve>();
-  curve->registerPoints(std::vector<glm::vec3>(std::begin(m_ctrlPoints), std::end(m_ctrlPoints)));
+  curve->registerPoints(std::span<const glm::vec3>{m_ctrlPoints});
   return curve;
 }
 
@@ -62,23 +72,95 @@ glm::vec3& gk::geometry::Bezier<N>::operator[](size_t index) {
   if (index < 0 || index >= N) {
     throw std::out_of_range("Index out of range");
   }
+  // the point may be modified through the reference
+  m_arcLength.clear();
   return m_ctrlPoints[index];
 }
 
+template <size_t N>
+glm::vec3 gk::geometry::Bezier<N>::point(float u) const {
+  return deCasteljau(u, std::span<const glm::vec3, N>{m_ctrlPoints});
+}
+
+template <size_t N>
+const gk::geometry::ArcLengthTable& gk::geometry::Bezier<N>::arcLength() {
+  if (!m_arcLength.empty()) {
+    return m_arcLength;
+  }
+
+  // number of uniform chords within tolerance of the curve, the tolerance being relative to the
+  // size of the control polygon
+  float polygon = 0.0f;
+  float maxSecondDifference = 0.0f;
+  for (size_t i = 1; i < N; ++i) {
+    polygon += glm::distance(m_ctrlPoints[i - 1], m_ctrlPoints[i]);
+    if (i + 1 < N) {
+      glm::vec3 difference = m_ctrlPoints[i - 1] - 2.0f * m_ctrlPoints[i] + m_ctrlPoints[i + 1];
+      maxSecondDifference = std::max(maxSecondDifference, glm::length(difference));
+    }
+  }
+  size_t samples = segmentsForTolerance(N - 1, maxSecondDifference, kArcLengthTolerance * polygon);
+  samples = std::clamp<size_t>(samples, 16, 4096);
+
+  std::vector<float> params(samples + 1);
+  for (size_t i = 0; i <= samples; ++i) {
+    params[i] = float(i) / float(samples);
+  }
+  std::vector<glm::vec3> points(params.size());
+  deCasteljau(std::span<const float>{params}, std::span<const glm::vec3, N>{m_ctrlPoints},
+              std::span<glm::vec3>{points});
+  m_arcLength.build(points);
+  return m_arcLength;
+}
+
+template <size_t N>
+float gk::geometry::Bezier<N>::length() {
+  return arcLength().length();
+}
+
+template <size_t N>
+glm::vec3 gk::geometry::Bezier<N>::pointAtDistance(float distance) {
+  return point(arcLength().parameter(distance));
+}
+
+template <size_t N>
+std::vector<glm::vec3> gk::geometry::Bezier<N>::sampleEquidistant(size_t count) {
+  std::vector<float> params(count);
+  arcLength().parameters(params);
+  std::vector<glm::vec3> points(count);
+  deCasteljau(std::span<const float>{params}, std::span<const glm::vec3, N>{m_ctrlPoints},
+              std::span<glm::vec3>{points});
+  return points;
+}
+
 template <size_t N>
 void gk::geometry::Bezier<N>::evaluate() {
-  m_curvePoints = std::vector<glm::vec3>();
-  m_curvePoints.reserve(m_nbPoints);
-  float epsilon = 1.0 / float(m_nbPoints);
-  for (float u = 0.0; u < 1.0f; u += epsilon) {
-    m_curvePoints.push_back(deCasteljau(u, std::begin(m_ctrlPoints), std::end(m_ctrlPoints)));
+  if (m_tolerance > 0.0f) {
+    m_curvePoints.clear();
+    m_curvePoints.push_back(m_ctrlPoints[0]);
+    adaptiveDeCasteljau(std::span<const glm::vec3, N>{m_ctrlPoints}, m_tolerance, m_curvePoints);
+    updateIndices();
+    return;
+  }
+
+  // parameters are generated one batch of the kernel at a time, on the stack
+  m_curvePoints.resize(m_nbPoints);
+  std::array<float, kDeCasteljauLanes> params;
+  for (size_t base = 0; base < m_curvePoints.size(); base += params.size()) {
+    const size_t count = std::min(params.size(), m_curvePoints.size() - base);
+    for (size_t i = 0; i < count; ++i) {
+      params[i] = float(base + i) / float(m_nbPoints);
+    }
+    deCasteljau(std::span<const float>{params.data(), count},
+                std::span<const glm::vec3, N>{m_ctrlPoints},
+                std::span<glm::vec3>{m_curvePoints}.subspan(base, count));
   }
   updateIndices();
 }
 
 template <size_t N>
 void gk::geometry::Bezier<N>::updateIndices() {
-  m_indices = std::vector<unsigned int>();
+  m_indices.clear();
   m_indices.reserve(m_curvePoints.size() * 2);
   for (size_t i = 0; i < m_curvePoints.size() - 1; ++i) {
     m_indices.push_back(i);
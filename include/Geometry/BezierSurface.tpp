@@ -4,10 +4,13 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtx/normal.hpp>
+#include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "Geometry/Surface.hpp"
@@ -16,7 +19,9 @@
 template <size_t M, size_t N>
 gk::geometry::BezierSurface<M, N>::BezierSurface(const std::array<glm::vec3, M * N>&& ctrlGrid,
                                                  size_t edges)
-    : m_ctrlGrid(ctrlGrid), m_meshEdges(edges) {
+    : m_ctrlGrid(ctrlGrid),
+      m_edgesU(std::max(edges, kMinMeshEdges)),
+      m_edgesV(std::max(edges, kMinMeshEdges)) {
   m_mesh = {std::vector<Mesh::Vertex>(), std::vector<unsigned int>()};
   evaluate();
 }
@@ -28,85 +33,292 @@ const gk::geometry::Mesh& gk::geometry::BezierSurface<M, N>::mesh() const {
 
 template <size_t M, size_t N>
 void gk::geometry::BezierSurface<M, N>::setMeshEdges(size_t edges) {
-  m_meshEdges = edges;
+  setMeshEdges(edges, edges);
+}
+
+template <size_t M, size_t N>
+void gk::geometry::BezierSurface<M, N>::setMeshEdges(size_t edgesU, size_t edgesV) {
+  // a grid of less than two samples has no cell, its index count would wrap around
+  m_edgesU = std::max(edgesU, kMinMeshEdges);
+  m_edgesV = std::max(edgesV, kMinMeshEdges);
   evaluate();
 }
 
 template <size_t M, size_t N>
-void gk::geometry::BezierSurface<M, N>::evaluate() {
-  std::vector<glm::vec3> q_points(M * m_meshEdges, glm::vec3(0.0, 0.0, 0.0));
+size_t gk::geometry::BezierSurface<M, N>::meshEdgesU() const {
+  return m_edgesU;
+}
+
+template <size_t M, size_t N>
+size_t gk::geometry::BezierSurface<M, N>::meshEdgesV() const {
+  return m_edgesV;
+}
+
+namespace gk::geometry::detail {
+
+// Edges along u and v keeping a uniform grid of the patch within tolerance of the surface. The
+// error of the tensor product is at most the sum of the errors along u and v, each direction gets
+// half of the tolerance.
+template <size_t M, size_t N>
+std::pair<size_t, size_t> edgesForTolerance(std::span<const glm::vec3, M * N> ctrlGrid,
+                                            float tolerance) {
+  // largest second difference of the control net in each parametric direction
+  float secondDiffU = 0.0f;
+  for (size_t i = 1; i + 1 < M; ++i) {
+    for (size_t k = 0; k < N; ++k) {
+      const glm::vec3 diff =
+          ctrlGrid[(i - 1) * N + k] - 2.0f * ctrlGrid[i * N + k] + ctrlGrid[(i + 1) * N + k];
+      secondDiffU = std::max(secondDiffU, glm::length(diff));
+    }
+  }
+  float secondDiffV = 0.0f;
   for (size_t i = 0; i < M; ++i) {
-    for (size_t j = 0; j < m_meshEdges; ++j) {
-      float v = float(j) / float(m_meshEdges - 1);
-      q_points[j * M + i] =
-          deCasteljau(v, m_ctrlGrid.cbegin() + i * N, m_ctrlGrid.cbegin() + i * N + N);
+    for (size_t k = 1; k + 1 < N; ++k) {
+      const glm::vec3 diff =
+          ctrlGrid[i * N + k - 1] - 2.0f * ctrlGrid[i * N + k] + ctrlGrid[i * N + k + 1];
+      secondDiffV = std::max(secondDiffV, glm::length(diff));
     }
   }
+  return {segmentsForTolerance(M - 1, secondDiffU, 0.5f * tolerance) + 1,
+          segmentsForTolerance(N - 1, secondDiffV, 0.5f * tolerance) + 1};
+}
+
+// Normal and tangent of a vertex from the partial derivatives of the surface
+inline void updateFrame(Mesh::Vertex& vertex, const glm::vec3& du, const glm::vec3& dv,
+                        const glm::vec3& fallbackNormal) {
+  // a degenerate edge of the patch (collapsed control points) has a null derivative,
+  // the neighbouring normal is used there
+  glm::vec3 normal = glm::cross(dv, du);
+  float normalLength = glm::length(normal);
+  vertex.normal = normalLength > 1e-12f ? normal / normalLength : fallbackNormal;
 
-  for (size_t i = 0; i < q_points.size() / M; ++i) {
-    for (size_t j = 0; j < m_meshEdges; ++j) {
-      float u = float(j) / float(m_meshEdges - 1);
+  float duLength = glm::length(du);
+  glm::vec3 tangent = duLength > 1e-12f ? du / duLength : glm::vec3(1.0f, 0.0f, 0.0f);
+  float handedness = glm::dot(glm::cross(vertex.normal, tangent), dv) < 0.0f ? -1.0f : 1.0f;
+  vertex.tangent = glm::vec4(tangent, handedness);
+}
 
-      Mesh::Vertex vertex;
-      vertex.position = deCasteljau(u, q_points.cbegin() + i * M, q_points.cbegin() + (i + 1) * M);
-      vertex.normal = glm::vec3(0.0, 0.0, 0.0);
-      vertex.uv =
-          glm::vec2(static_cast<float>(i) / m_meshEdges, static_cast<float>(j) / m_meshEdges);
-      m_mesh.vertices.push_back(vertex);
+// Evaluates positions, normals and tangents of a patch on the grid of the basis tables.
+// S = B_u . P . B_v^T, dS/du = B'_u . P . B_v^T, dS/dv = B_u . P . B'_v^T
+// du and dv receive the partial derivatives at every vertex, or are empty when not needed.
+template <size_t M, size_t N>
+void evaluatePatch(std::span<const glm::vec3, M * N> ctrlGrid, const BernsteinTable<M>& basisU,
+                   const BernsteinTable<N>& basisV, std::span<Mesh::Vertex> vertices,
+                   std::span<glm::vec3> du, std::span<glm::vec3> dv, PatchScratch& scratch) {
+  const size_t edgesU = basisU.samples();
+  const size_t edgesV = basisV.samples();
+
+  // first contract the control grid along v: T = P . B_v^T, T' = P . B'_v^T
+  scratch.partial.resize(edgesV * M);
+  scratch.partialDv.resize(edgesV * M);
+  for (size_t j = 0; j < edgesV; ++j) {
+    for (size_t i = 0; i < M; ++i) {
+      glm::vec3 point(0.0f);
+      glm::vec3 derivative(0.0f);
+      for (size_t k = 0; k < N; ++k) {
+        point += ctrlGrid[i * N + k] * basisV(k, j);
+        derivative += ctrlGrid[i * N + k] * basisV.derivative(k, j);
+      }
+      scratch.partial[j * M + i] = point;
+      scratch.partialDv[j * M + i] = derivative;
     }
   }
 
-  calculateIndices();
-  // TODO: calculate normals with bezier derivative
-  calculateNormals();
-}
+  // then along u, accumulating a whole row of the mesh at once in structure of arrays form:
+  // S = B_u . T, dS/du = B'_u . T, dS/dv = B_u . T'
+  scratch.soa.resize(9 * edgesU);
+  for (size_t i = 0; i < edgesV; ++i) {
+    std::fill(scratch.soa.begin(), scratch.soa.end(), 0.0f);
+    float* xs = scratch.soa.data();
+    float* ys = xs + edgesU;
+    float* zs = ys + edgesU;
+    float* dux = zs + edgesU;
+    float* duy = dux + edgesU;
+    float* duz = duy + edgesU;
+    float* dvx = duz + edgesU;
+    float* dvy = dvx + edgesU;
+    float* dvz = dvy + edgesU;
 
-template <size_t M, size_t N>
-void gk::geometry::BezierSurface<M, N>::calculateIndices() {
-  m_mesh.indices.reserve(m_meshEdges * m_meshEdges * 6);
+    for (size_t k = 0; k < M; ++k) {
+      const glm::vec3 t = scratch.partial[i * M + k];
+      const glm::vec3 tv = scratch.partialDv[i * M + k];
+      const auto basis = basisU.basis(k);
+      const auto derivative = basisU.derivative(k);
+      for (size_t j = 0; j < edgesU; ++j) {
+        xs[j] += t.x * basis[j];
+        ys[j] += t.y * basis[j];
+        zs[j] += t.z * basis[j];
+        dux[j] += t.x * derivative[j];
+        duy[j] += t.y * derivative[j];
+        duz[j] += t.z * derivative[j];
+        dvx[j] += tv.x * basis[j];
+        dvy[j] += tv.y * basis[j];
+        dvz[j] += tv.z * basis[j];
+      }
+    }
+
+    glm::vec3 previousNormal(0.0f, 1.0f, 0.0f);
+    for (size_t j = 0; j < edgesU; ++j) {
+      const size_t index = i * edgesU + j;
+      const glm::vec3 su(dux[j], duy[j], duz[j]);
+      const glm::vec3 sv(dvx[j], dvy[j], dvz[j]);
+      if (!du.empty()) {
+        du[index] = su;
+        dv[index] = sv;
+      }
+
+      auto& vertex = vertices[index];
+      vertex.position = glm::vec3(xs[j], ys[j], zs[j]);
+      updateFrame(vertex, su, sv, previousNormal);
+      previousNormal = vertex.normal;
+      vertex.uv = glm::vec2(static_cast<float>(i) / edgesV, static_cast<float>(j) / edgesU);
+    }
+  }
+}
 
-  for (unsigned int i = 0; i < m_meshEdges - 1; ++i) {
-    for (unsigned int j = 0; j < m_meshEdges - 1; ++j) {
+// Two triangles per cell of an edgesU x edgesV grid of vertices starting at baseVertex
+inline void gridIndices(size_t edgesU, size_t edgesV, unsigned int baseVertex,
+                        std::span<unsigned int> indices) {
+  auto index = indices.begin();
+  for (unsigned int i = 0; i < edgesV - 1; ++i) {
+    for (unsigned int j = 0; j < edgesU - 1; ++j) {
+      const unsigned int corner = baseVertex + i * edgesU + j;
       // first triangle
-      m_mesh.indices.push_back(i * m_meshEdges + j);
-      m_mesh.indices.push_back(i * m_meshEdges + j + 1);
-      m_mesh.indices.push_back(i * m_meshEdges + j + m_meshEdges);
+      *index++ = corner;
+      *index++ = corner + 1;
+      *index++ = corner + edgesU;
       // second triangle
-      m_mesh.indices.push_back(i * m_meshEdges + j + 1);
-      m_mesh.indices.push_back(i * m_meshEdges + j + m_meshEdges);
-      m_mesh.indices.push_back(i * m_meshEdges + j + m_meshEdges + 1);
+      *index++ = corner + 1;
+      *index++ = corner + edgesU;
+      *index++ = corner + edgesU + 1;
     }
   }
 }
 
+}  // namespace gk::geometry::detail
+
 template <size_t M, size_t N>
-void gk::geometry::BezierSurface<M, N>::calculateNormals() {
-  for (size_t i = 0; i < m_meshEdges - 1; i++) {
-    for (size_t j = 0; j < m_meshEdges - 1; j++) {
-      auto p0 = &m_mesh.vertices[i * m_meshEdges + j].position;
-      auto p1 = &m_mesh.vertices[i * m_meshEdges + j + 1].position;
-      auto p2 = &m_mesh.vertices[i * m_meshEdges + j + m_meshEdges].position;
-      auto p3 = &m_mesh.vertices[i * m_meshEdges + j + m_meshEdges + 1].position;
-
-      auto v0 = *p2 - *p0;
-      auto v1 = *p1 - *p0;
-      auto v2 = *p3 - *p1;
-
-      if (i == m_meshEdges - 2) {
-        auto v3 = *p3 - *p2;
-        m_mesh.vertices[(i + 1) * m_meshEdges + j].normal += glm::normalize(glm::cross(v0, v3));
-
-        if (i == j) {
-          m_mesh.vertices[(i + 1) * m_meshEdges + j + 1].normal +=
-              glm::normalize(glm::cross(v2, v3));
-        }
-      }
+void gk::geometry::BezierSurface<M, N>::tessellate(float tolerance, size_t maxEdges) {
+  const auto [edgesU, edgesV] =
+      detail::edgesForTolerance<M, N>(std::span<const glm::vec3, M * N>{m_ctrlGrid}, tolerance);
+  setMeshEdges(std::min(edgesU, maxEdges), std::min(edgesV, maxEdges));
+}
 
-      if (j == m_meshEdges - 2) {
-        m_mesh.vertices[i * m_meshEdges + j + 1].normal += glm::normalize(glm::cross(v2, v1));
-      }
+template <size_t M, size_t N>
+void gk::geometry::BezierSurface<M, N>::evaluate() {
+  m_basisU.resize(m_edgesU);
+  m_basisV.resize(m_edgesV);
+
+  // resized in place so re-evaluating reuses the capacity of the previous tessellation
+  m_mesh.vertices.resize(m_edgesU * m_edgesV);
+  m_du.resize(m_edgesU * m_edgesV);
+  m_dv.resize(m_edgesU * m_edgesV);
+  detail::evaluatePatch<M, N>(std::span<const glm::vec3, M * N>{m_ctrlGrid}, m_basisU, m_basisV,
+                              std::span<Mesh::Vertex>{m_mesh.vertices}, m_du, m_dv, m_scratch);
+
+  // the connectivity only depends on the number of edges
+  if (m_indexedEdgesU != m_edgesU || m_indexedEdgesV != m_edgesV) {
+    calculateIndices();
+  }
+}
+
+template <size_t M, size_t N>
+const glm::vec3& gk::geometry::BezierSurface<M, N>::ctrlPoint(size_t i, size_t j) const {
+  return m_ctrlGrid[i * N + j];
+}
+
+template <size_t M, size_t N>
+gk::geometry::VertexRange gk::geometry::BezierSurface<M, N>::moveControlPoint(
+    size_t i, size_t j, const glm::vec3& delta) {
+  if (i >= M || j >= N) {
+    throw std::out_of_range("Index out of range");
+  }
+  m_ctrlGrid[i * N + j] += delta;
+
+  // rows of the mesh (v samples) where the point has an influence on the position or the normal
+  size_t firstRow = m_edgesV;
+  size_t lastRow = 0;
+  for (size_t row = 0; row < m_edgesV; ++row) {
+    const float bv = m_basisV(j, row);
+    const float dbv = m_basisV.derivative(j, row);
+    if (bv != 0.0f || dbv != 0.0f) {
+      firstRow = std::min(firstRow, row);
+      lastRow = row;
+    }
+  }
+  if (firstRow > lastRow) {
+    return {};
+  }
+
+  const auto bu = m_basisU.basis(i);
+  const auto dbu = m_basisU.derivative(i);
+  for (size_t row = firstRow; row <= lastRow; ++row) {
+    const glm::vec3 dRow = delta * m_basisV(j, row);
+    const glm::vec3 dRowDv = delta * m_basisV.derivative(j, row);
+    glm::vec3 previousNormal = m_mesh.vertices[row * m_edgesU].normal;
+    for (size_t col = 0; col < m_edgesU; ++col) {
+      const size_t index = row * m_edgesU + col;
+      auto& vertex = m_mesh.vertices[index];
+      vertex.position += dRow * bu[col];
+      m_du[index] += dRow * dbu[col];
+      m_dv[index] += dRowDv * bu[col];
+      detail::updateFrame(vertex, m_du[index], m_dv[index], previousNormal);
+      previousNormal = vertex.normal;
+    }
+  }
+
+  return {firstRow * m_edgesU, (lastRow - firstRow + 1) * m_edgesU};
+}
+
+template <size_t M, size_t N>
+void gk::geometry::BezierSurface<M, N>::calculateIndices() {
+  m_mesh.indices.resize((m_edgesV - 1) * (m_edgesU - 1) * 6);
+  detail::gridIndices(m_edgesU, m_edgesV, 0, m_mesh.indices);
+  m_indexedEdgesU = m_edgesU;
+  m_indexedEdgesV = m_edgesV;
+}
+
+template <size_t M, size_t N>
+void gk::geometry::tessellatePatches(std::span<const std::array<glm::vec3, M * N>> ctrlGrids,
+                                     size_t edges, Mesh& mesh, core::ThreadPool& pool) {
+  edges = std::max(edges, kMinMeshEdges);
+  // the parameter grid is shared by every patch
+  BernsteinTable<M> basisU;
+  BernsteinTable<N> basisV;
+  basisU.resize(edges);
+  basisV.resize(edges);
 
-      m_mesh.vertices[i * m_meshEdges + j].normal = glm::normalize(glm::cross(v0, v1));
+  const size_t patchVertices = edges * edges;
+  const size_t patchIndices = (edges - 1) * (edges - 1) * 6;
+  mesh.vertices.resize(ctrlGrids.size() * patchVertices);
+  mesh.indices.resize(ctrlGrids.size() * patchIndices);
+
+  // each patch writes its own slice of the shared buffers
+  pool.parallelFor(ctrlGrids.size(), 1, [&](size_t begin, size_t end) {
+    detail::PatchScratch scratch;
+    for (size_t patch = begin; patch < end; ++patch) {
+      detail::evaluatePatch<M, N>(
+          std::span<const glm::vec3, M * N>{ctrlGrids[patch]}, basisU, basisV,
+          std::span<Mesh::Vertex>{mesh.vertices}.subspan(patch * patchVertices, patchVertices),
+          {}, {}, scratch);
+      detail::gridIndices(
+          edges, edges, patch * patchVertices,
+          std::span<unsigned int>{mesh.indices}.subspan(patch * patchIndices, patchIndices));
     }
+  });
+}
+
+template <size_t M, size_t N>
+size_t gk::geometry::tessellatePatchesToTolerance(
+    std::span<const std::array<glm::vec3, M * N>> ctrlGrids, float tolerance, Mesh& mesh,
+    core::ThreadPool& pool, size_t maxEdges) {
+  size_t edges = kMinMeshEdges;
+  for (const auto& ctrlGrid : ctrlGrids) {
+    const auto [edgesU, edgesV] =
+        detail::edgesForTolerance<M, N>(std::span<const glm::vec3, M * N>{ctrlGrid}, tolerance);
+    edges = std::max({edges, edgesU, edgesV});
   }
+  edges = std::min(edges, std::max(maxEdges, kMinMeshEdges));
+  tessellatePatches<M, N>(ctrlGrids, edges, mesh, pool);
+  return edges;
 }
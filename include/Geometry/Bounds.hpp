@@ -0,0 +1,89 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <limits>
+#include <span>
+
+namespace gk::geometry {
+
+// Axis aligned bounding box, empty while min is above max
+struct AABB {
+  glm::vec3 min{std::numeric_limits<float>::max()};
+  glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+  bool empty() const noexcept;
+  glm::vec3 center() const noexcept;
+  glm::vec3 extents() const noexcept;
+  float surfaceArea() const noexcept;
+  bool contains(const AABB& other) const noexcept;
+
+  void expand(const glm::vec3& point) noexcept;
+  void expand(const AABB& other) noexcept;
+  // Box around the transformed corners of this box
+  AABB transformed(const glm::mat4& transform) const noexcept;
+
+  friend bool operator==(const AABB&, const AABB&) = default;
+};
+
+AABB merge(const AABB& a, const AABB& b) noexcept;
+
+struct BoundingSphere {
+  glm::vec3 center{0.0f};
+  // negative for an empty sphere
+  float radius = -1.0f;
+};
+
+// Box of the positions of vertices, any vertex type with a position member
+template <typename Vertex>
+AABB computeBounds(std::span<const Vertex> vertices) noexcept;
+
+// Sphere centered on the box of the vertices, with the radius of the farthest vertex
+template <typename Vertex>
+BoundingSphere computeBoundingSphere(std::span<const Vertex> vertices) noexcept;
+
+// The six planes of a view frustum, pointing inside, xyz the normal and w the distance
+class Frustum {
+ public:
+  // Planes of the clip volume of viewProjection, i.e. projection * view
+  explicit Frustum(const glm::mat4& viewProjection) noexcept;
+
+  // Conservative, a box crossing two planes outside the frustum near a corner is kept
+  bool intersects(const AABB& box) const noexcept;
+  bool intersects(const BoundingSphere& sphere) const noexcept;
+
+ private:
+  std::array<glm::vec4, 6> m_planes;
+};
+
+template <typename Vertex>
+AABB computeBounds(std::span<const Vertex> vertices) noexcept {
+  AABB box;
+  for (const auto& vertex : vertices) {
+    box.expand(glm::vec3(vertex.position));
+  }
+  return box;
+}
+
+template <typename Vertex>
+BoundingSphere computeBoundingSphere(std::span<const Vertex> vertices) noexcept {
+  const AABB box = computeBounds(vertices);
+  if (box.empty()) {
+    return {};
+  }
+  BoundingSphere sphere{box.center(), 0.0f};
+  for (const auto& vertex : vertices) {
+    const glm::vec3 offset = glm::vec3(vertex.position) - sphere.center;
+    sphere.radius = std::max(sphere.radius, glm::dot(offset, offset));
+  }
+  sphere.radius = std::sqrt(sphere.radius);
+  return sphere;
+}
+
+}  // namespace gk::geometry
@@ -4,11 +4,13 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <glm/glm.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace gk::geometry {
@@ -24,18 +26,44 @@ class SimpleCurve : Curve {
  public:
   void registerPoint(glm::vec2 point);
   void registerPoint(glm::vec3 point);
-  void registerPoints(std::vector<glm::vec2> points);
-  void registerPoints(std::vector<glm::vec3> points);
+  void registerPoints(std::span<const glm::vec2> points);
+  void registerPoints(std::span<const glm::vec3> points);
   const std::vector<unsigned>& indices() override;
   const std::vector<glm::vec3>& curve() override;
   glm::vec3& operator[](size_t index);
 
  private:
-  void updateIndices();
+  // Makes room for count more points, growing the buffers geometrically
+  void reserve(size_t count);
+  // Appends the line indices joining the points registered from first onwards to the previous ones
+  void appendIndices(size_t first);
   std::vector<glm::vec3> m_points;
   std::vector<unsigned> m_indices;
 };
 
+// Cumulative length of a curve sampled at uniform parameters, used to map a curvilinear abscissa
+// back to a parameter
+class ArcLengthTable {
+ public:
+  // position(t) evaluates the curve for t in [0, 1]
+  template <typename PositionFn>
+  void build(PositionFn&& position, size_t samples);
+  // points sampled at uniform parameters, end points included
+  void build(std::span<const glm::vec3> points);
+  void clear() noexcept;
+  bool empty() const noexcept;
+  float length() const noexcept;
+  // Parameter in [0, 1] at which the curve reaches the curvilinear abscissa distance, found by
+  // binary search
+  float parameter(float distance) const noexcept;
+  // Parameters of out.size() points evenly spaced along the curve, both end points included.
+  // The abscissae are increasing so the table is swept once instead of searched for each point.
+  void parameters(std::span<float> out) const noexcept;
+
+ private:
+  std::vector<float> m_lengths;
+};
+
 template <size_t N>
 class Bezier : Curve {
  public:
@@ -48,21 +76,98 @@ class Bezier : Curve {
   const std::unique_ptr<SimpleCurve> ctrlCurve();
 
   unsigned int nbSegments();
+  // Uniform sampling with nbSegments segments
   void setNbSegments(unsigned int nbSegments);
+  // Adaptive sampling, the curve is subdivided until it is within tolerance of its polyline
+  void setTolerance(float tolerance);
+
+  // Point of the curve at the parameter u in [0, 1]
+  glm::vec3 point(float u) const;
+
+  // The following use an arc-length table built on first use and cached until a control point
+  // is accessed for writing. Its chords stay within kArcLengthTolerance times the length of the
+  // control polygon from the curve, which bounds the error of every lookup.
+  float length();
+  // Point at the curvilinear abscissa distance in [0, length()], for constant speed motion
+  glm::vec3 pointAtDistance(float distance);
+  // count points evenly spaced along the curve, both end points included
+  std::vector<glm::vec3> sampleEquidistant(size_t count);
 
   glm::vec3& operator[](size_t index);
 
  private:
+  static constexpr float kArcLengthTolerance = 1e-4f;
+
   void evaluate();
   void updateIndices();
+  const ArcLengthTable& arcLength();
   glm::vec3 m_ctrlPoints[N];
   std::vector<glm::vec3> m_curvePoints;
   std::vector<unsigned> m_indices;
   unsigned int m_nbPoints;
+  // 0 for uniform sampling
+  float m_tolerance = 0.0f;
+  ArcLengthTable m_arcLength;
+};
+
+// Cubic Bezier segments, consecutive segments share their end control point
+struct CubicBezierBasis {
+  static constexpr size_t kStride = 3;
+  static std::array<float, 4> weights(float t);
+  static std::array<float, 4> derivatives(float t);
+};
+
+// Uniform cubic B-spline, every window of 4 consecutive control points is a segment
+struct CubicBSplineBasis {
+  static constexpr size_t kStride = 1;
+  static std::array<float, 4> weights(float t);
+  static std::array<float, 4> derivatives(float t);
+};
+
+// Curve made of cubic segments stored in one contiguous control point array.
+// The parameter t in [0, 1] spans the whole curve and each segment covers an equal share of it,
+// so finding the segment of a parameter is a single multiplication.
+// Control points that do not complete a segment are ignored.
+template <typename Basis>
+class PiecewiseCubic : public Curve {
+ public:
+  PiecewiseCubic(std::vector<glm::vec3> ctrlPoints, unsigned int nbPoints = 100);
+
+  const std::vector<unsigned>& indices() override;
+  const std::vector<glm::vec3>& curve() override;
+
+  std::span<const glm::vec3> ctrlPoints() const noexcept;
+  void setCtrlPoint(size_t index, const glm::vec3& point);
+  size_t nbSegments() const noexcept;
+
+  glm::vec3 evaluate(float t) const noexcept;
+  glm::vec3 derivative(float t) const noexcept;
+
+  // The following use an arc-length table built on first use and cached until a control point
+  // is modified, so editing the curve does not pay for the sampling
+  float length();
+  // Point at the curvilinear abscissa distance in [0, length()], for constant speed motion
+  glm::vec3 pointAtDistance(float distance);
+  // count points evenly spaced along the curve, both end points included
+  std::vector<glm::vec3> sampleEquidistant(size_t count);
+
+ private:
+  size_t segment(float t, float& local) const noexcept;
+  void update();
+  const ArcLengthTable& arcLength();
+
+  std::vector<glm::vec3> m_ctrlPoints;
+  size_t m_nbSegments;
+  std::vector<glm::vec3> m_curvePoints;
+  std::vector<unsigned> m_indices;
+  unsigned int m_nbPoints;
+  ArcLengthTable m_arcLength;
 };
 
-// TODO: PieceWiseBezier
+using PiecewiseBezier = PiecewiseCubic<CubicBezierBasis>;
+using UniformBSpline = PiecewiseCubic<CubicBSplineBasis>;
 
 }  // namespace gk::geometry
 
 #include "Bezier.tpp"
+#include "PiecewiseCubic.tpp"
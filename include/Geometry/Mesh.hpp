@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <vector>
 
@@ -14,8 +15,16 @@ struct Mesh {
     glm::vec3 position;
     glm::vec3 normal;
     glm::vec2 uv;
+    // xyz is the direction of increasing u, w the handedness of the bitangent
+    glm::vec4 tangent;
   };
   std::vector<Vertex> vertices;
   std::vector<unsigned> indices;
 };
+
+// Contiguous range of vertices modified by an in place update of a mesh
+struct VertexRange {
+  size_t offset = 0;
+  size_t count = 0;
+};
 }  // namespace gk::geometry
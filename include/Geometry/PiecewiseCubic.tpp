@@ -0,0 +1,144 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "Geometry/Curves.hpp"
+
+template <typename PositionFn>
+void gk::geometry::ArcLengthTable::build(PositionFn&& position, size_t samples) {
+  samples = std::max<size_t>(samples, 1);
+  m_lengths.resize(samples + 1);
+  m_lengths[0] = 0.0f;
+  glm::vec3 previous = position(0.0f);
+  for (size_t i = 1; i <= samples; ++i) {
+    glm::vec3 current = position(float(i) / float(samples));
+    m_lengths[i] = m_lengths[i - 1] + glm::distance(previous, current);
+    previous = current;
+  }
+}
+
+template <typename Basis>
+gk::geometry::PiecewiseCubic<Basis>::PiecewiseCubic(std::vector<glm::vec3> ctrlPoints,
+                                                    unsigned int nbPoints)
+    : m_ctrlPoints(std::move(ctrlPoints)), m_nbPoints(std::max(nbPoints, 2u)) {
+  m_nbSegments = m_ctrlPoints.size() < 4 ? 0 : (m_ctrlPoints.size() - 4) / Basis::kStride + 1;
+  update();
+}
+
+template <typename Basis>
+const std::vector<unsigned>& gk::geometry::PiecewiseCubic<Basis>::indices() {
+  return m_indices;
+}
+
+template <typename Basis>
+const std::vector<glm::vec3>& gk::geometry::PiecewiseCubic<Basis>::curve() {
+  return m_curvePoints;
+}
+
+template <typename Basis>
+std::span<const glm::vec3> gk::geometry::PiecewiseCubic<Basis>::ctrlPoints() const noexcept {
+  return m_ctrlPoints;
+}
+
+template <typename Basis>
+void gk::geometry::PiecewiseCubic<Basis>::setCtrlPoint(size_t index, const glm::vec3& point) {
+  if (index >= m_ctrlPoints.size()) {
+    throw std::out_of_range("Index out of range");
+  }
+  m_ctrlPoints[index] = point;
+  update();
+}
+
+template <typename Basis>
+size_t gk::geometry::PiecewiseCubic<Basis>::nbSegments() const noexcept {
+  return m_nbSegments;
+}
+
+template <typename Basis>
+size_t gk::geometry::PiecewiseCubic<Basis>::segment(float t, float& local) const noexcept {
+  const float scaled = std::clamp(t, 0.0f, 1.0f) * float(m_nbSegments);
+  const size_t index = std::min(size_t(scaled), m_nbSegments - 1);
+  local = scaled - float(index);
+  return index;
+}
+
+template <typename Basis>
+glm::vec3 gk::geometry::PiecewiseCubic<Basis>::evaluate(float t) const noexcept {
+  if (m_nbSegments == 0) {
+    return m_ctrlPoints.empty() ? glm::vec3(0.0f) : m_ctrlPoints[0];
+  }
+  float local;
+  const glm::vec3* points = m_ctrlPoints.data() + segment(t, local) * Basis::kStride;
+  const auto w = Basis::weights(local);
+  return points[0] * w[0] + points[1] * w[1] + points[2] * w[2] + points[3] * w[3];
+}
+
+template <typename Basis>
+glm::vec3 gk::geometry::PiecewiseCubic<Basis>::derivative(float t) const noexcept {
+  if (m_nbSegments == 0) {
+    return glm::vec3(0.0f);
+  }
+  float local;
+  const glm::vec3* points = m_ctrlPoints.data() + segment(t, local) * Basis::kStride;
+  const auto w = Basis::derivatives(local);
+  // chain rule, a segment only covers 1 / nbSegments of the parameter range
+  return (points[0] * w[0] + points[1] * w[1] + points[2] * w[2] + points[3] * w[3]) *
+         float(m_nbSegments);
+}
+
+template <typename Basis>
+const gk::geometry::ArcLengthTable& gk::geometry::PiecewiseCubic<Basis>::arcLength() {
+  if (m_arcLength.empty()) {
+    // 16 chords per segment keep the table within a fraction of a percent of the true length
+    const size_t samples = std::max<size_t>(m_nbSegments, 1) * 16;
+    m_arcLength.build([this](float t) { return evaluate(t); }, samples);
+  }
+  return m_arcLength;
+}
+
+template <typename Basis>
+float gk::geometry::PiecewiseCubic<Basis>::length() {
+  return arcLength().length();
+}
+
+template <typename Basis>
+glm::vec3 gk::geometry::PiecewiseCubic<Basis>::pointAtDistance(float distance) {
+  return evaluate(arcLength().parameter(distance));
+}
+
+template <typename Basis>
+std::vector<glm::vec3> gk::geometry::PiecewiseCubic<Basis>::sampleEquidistant(size_t count) {
+  std::vector<float> params(count);
+  arcLength().parameters(params);
+  std::vector<glm::vec3> points(count);
+  for (size_t i = 0; i < count; ++i) {
+    points[i] = evaluate(params[i]);
+  }
+  return points;
+}
+
+template <typename Basis>
+void gk::geometry::PiecewiseCubic<Basis>::update() {
+  m_curvePoints.resize(m_nbPoints);
+  for (size_t i = 0; i < m_curvePoints.size(); ++i) {
+    m_curvePoints[i] = evaluate(float(i) / float(m_nbPoints - 1));
+  }
+
+  m_indices.resize(2 * (m_curvePoints.size() - 1));
+  for (size_t i = 0; i + 1 < m_curvePoints.size(); ++i) {
+    m_indices[2 * i] = i;
+    m_indices[2 * i + 1] = i + 1;
+  }
+
+  // rebuilt on the next length query
+  m_arcLength.clear();
+}
@@ -6,11 +6,28 @@
 
 #include <array>
 #include <cstddef>
+#include <span>
+#include <vector>
 
+#include "Core/ThreadPool.hpp"
+#include "Geometry/algorithm.hpp"
 #include "Mesh.hpp"
 
 namespace gk::geometry {
 
+namespace detail {
+// Scratch buffers of the patch kernel, reused between evaluations
+struct PatchScratch {
+  // control grid contracted along v, one row of M points per v sample, and its v derivative
+  std::vector<glm::vec3> partial;
+  std::vector<glm::vec3> partialDv;
+  std::vector<float> soa;
+};
+}  // namespace detail
+
+// Fewest samples along u or v, smaller numbers of edges are raised to it
+inline constexpr size_t kMinMeshEdges = 2;
+
 class Surface {
  public:
   virtual const Mesh& mesh() const = 0;
@@ -22,17 +39,59 @@ class BezierSurface : public Surface {
   BezierSurface(const std::array<glm::vec3, M * N>&& ctrlGrid, size_t edges);
   virtual const Mesh& mesh() const override;
   void setMeshEdges(size_t edges);
+  void setMeshEdges(size_t edgesU, size_t edgesV);
+  size_t meshEdgesU() const;
+  size_t meshEdgesV() const;
+  // Picks the number of edges along u and v from the curvature of the control net so that the
+  // distance between the mesh and the surface stays under tolerance, see screenSpaceTolerance for
+  // an error in pixels. The grid stays uniform over the patch. Neighbouring surfaces with other
+  // numbers of edges leave cracks on their common border, tessellatePatchesToTolerance gives a
+  // crack free mesh of several patches.
+  void tessellate(float tolerance, size_t maxEdges = 256);
+
+  const glm::vec3& ctrlPoint(size_t i, size_t j) const;
+  // Moves the control point (i, j) by delta and patches the mesh in place, as the point only
+  // contributes B_i(u) B_j(v) delta to the surface. Returns the range of modified vertices: only
+  // the first or last rows for j = 0 or N - 1, but nearly the whole mesh for an interior j, as
+  // B_j(v) is only zero at the ends of the patch.
+  VertexRange moveControlPoint(size_t i, size_t j, const glm::vec3& delta);
 
  private:
   void evaluate();
   void calculateIndices();
-  void calculateNormals();
 
   std::array<glm::vec3, M * N> m_ctrlGrid;
   Mesh m_mesh;
-  size_t m_meshEdges;
+  // number of samples along u (columns of the mesh) and v (rows of the mesh)
+  size_t m_edgesU;
+  size_t m_edgesV;
+  // number of edges the index buffer was built for
+  size_t m_indexedEdgesU = 0;
+  size_t m_indexedEdgesV = 0;
+
+  // cached basis weights, only recomputed when the number of edges changes
+  BernsteinTable<M> m_basisU;
+  BernsteinTable<N> m_basisV;
+  detail::PatchScratch m_scratch;
+  // partial derivatives of the surface at every vertex, kept for incremental updates
+  std::vector<glm::vec3> m_du;
+  std::vector<glm::vec3> m_dv;
 };
 
+// Tessellates many patches in parallel into one mesh, ready for a single upload. Every patch is
+// sampled on the same edges x edges grid and writes directly into its own slice of the vertex
+// and index buffers.
+template <size_t M, size_t N>
+void tessellatePatches(std::span<const std::array<glm::vec3, M * N>> ctrlGrids, size_t edges,
+                       Mesh& mesh, core::ThreadPool& pool);
+// Same with the fewest edges keeping every patch within tolerance of its surface, capped by
+// maxEdges. Every patch gets that number of edges along u and v, so neighbouring patches sample
+// their common border at the same points and the mesh has no crack. Returns the number of edges.
+template <size_t M, size_t N>
+size_t tessellatePatchesToTolerance(std::span<const std::array<glm::vec3, M * N>> ctrlGrids,
+                                    float tolerance, Mesh& mesh, core::ThreadPool& pool,
+                                    size_t maxEdges = 256);
+
 }  // namespace gk::geometry
 
 #include "BezierSurface.tpp"
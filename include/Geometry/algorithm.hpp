@@ -4,21 +4,228 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
 #include <glm/glm.hpp>
+#include <span>
 #include <vector>
 
 namespace gk::geometry {
-template <typename Iterator>
-inline glm::vec3 deCasteljau(float u, Iterator begin, Iterator end) {
-  auto beta = std::vector<glm::vec3>(begin, end);
-  const auto n = beta.size();
 
-  for (size_t i = 1; i < n; ++i) {
-    for (size_t j = 0; j < n - i; j++) {
+// Number of parameter values evaluated together by the batched de Casteljau kernel.
+// The lanes are stored as plain float arrays so the compiler can map them on SSE/AVX registers.
+inline constexpr size_t kDeCasteljauLanes = 8;
+
+// Evaluates the Bezier curve defined by N control points at u, using stack storage only
+template <size_t N>
+inline glm::vec3 deCasteljau(float u, std::span<const glm::vec3, N> ctrlPoints) {
+  static_assert(N > 0, "a Bezier curve needs at least one control point");
+  glm::vec3 beta[N];
+  std::copy(ctrlPoints.begin(), ctrlPoints.end(), beta);
+
+  for (size_t i = 1; i < N; ++i) {
+    for (size_t j = 0; j < N - i; ++j) {
       beta[j] = beta[j] * (1.0f - u) + beta[j + 1] * u;
     }
   }
   return beta[0];
 }
+
+// Evaluates the Bezier curve defined by N control points at every parameter of us.
+// out must hold at least us.size() points.
+template <size_t N>
+inline void deCasteljau(std::span<const float> us, std::span<const glm::vec3, N> ctrlPoints,
+                        std::span<glm::vec3> out) {
+  static_assert(N > 0, "a Bezier curve needs at least one control point");
+  constexpr size_t L = kDeCasteljauLanes;
+
+  for (size_t base = 0; base < us.size(); base += L) {
+    const size_t lanes = std::min(L, us.size() - base);
+
+    float u[L] = {};
+    for (size_t l = 0; l < lanes; ++l) {
+      u[l] = us[base + l];
+    }
+
+    // structure of arrays: one lane per parameter value
+    float x[N][L], y[N][L], z[N][L];
+    for (size_t k = 0; k < N; ++k) {
+      for (size_t l = 0; l < L; ++l) {
+        x[k][l] = ctrlPoints[k].x;
+        y[k][l] = ctrlPoints[k].y;
+        z[k][l] = ctrlPoints[k].z;
+      }
+    }
+
+    for (size_t i = 1; i < N; ++i) {
+      for (size_t k = 0; k < N - i; ++k) {
+        for (size_t l = 0; l < L; ++l) {
+          x[k][l] = x[k][l] * (1.0f - u[l]) + x[k + 1][l] * u[l];
+          y[k][l] = y[k][l] * (1.0f - u[l]) + y[k + 1][l] * u[l];
+          z[k][l] = z[k][l] * (1.0f - u[l]) + z[k + 1][l] * u[l];
+        }
+      }
+    }
+
+    for (size_t l = 0; l < lanes; ++l) {
+      out[base + l] = glm::vec3(x[0][l], y[0][l], z[0][l]);
+    }
+  }
+}
+
+// Bernstein basis of the curve defined by N control points (degree N - 1), evaluated at u
+template <size_t N>
+inline std::array<float, N> bernstein(float u) {
+  static_assert(N > 0, "a Bezier curve needs at least one control point");
+  std::array<float, N> weights{};
+  weights[0] = 1.0f;
+  // raise the degree one step at a time, B_{k,d+1} = (1 - u) B_{k,d} + u B_{k-1,d}
+  for (size_t d = 1; d < N; ++d) {
+    for (size_t k = d; k > 0; --k) {
+      weights[k] = weights[k] * (1.0f - u) + weights[k - 1] * u;
+    }
+    weights[0] *= 1.0f - u;
+  }
+  return weights;
+}
+
+// Derivative of the Bernstein basis of the curve defined by N control points, evaluated at u.
+// B'_{k,n} = n (B_{k-1,n-1} - B_{k,n-1})
+template <size_t N>
+inline std::array<float, N> bernsteinDerivative(float u) {
+  static_assert(N > 0, "a Bezier curve needs at least one control point");
+  std::array<float, N> derivatives{};
+  if constexpr (N > 1) {
+    const auto lower = bernstein<N - 1>(u);
+    const float degree = float(N - 1);
+    for (size_t k = 0; k < N; ++k) {
+      float previous = k > 0 ? lower[k - 1] : 0.0f;
+      float current = k < N - 1 ? lower[k] : 0.0f;
+      derivatives[k] = degree * (previous - current);
+    }
+  }
+  return derivatives;
+}
+
+// Bernstein weights (and their derivatives) of the curve defined by N control points sampled on
+// the uniform grid u_j = j / (samples - 1). The weights of a basis function are contiguous over
+// the samples so a tessellation can be computed as a dense matrix product with vectorised inner
+// loops.
+template <size_t N>
+class BernsteinTable {
+ public:
+  // Recomputes the table only if the number of samples changed
+  void resize(size_t samples) {
+    if (samples == m_samples) return;
+    m_samples = samples;
+    m_weights.resize(N * samples);
+    m_derivatives.resize(N * samples);
+    for (size_t j = 0; j < samples; ++j) {
+      float u = samples > 1 ? float(j) / float(samples - 1) : 0.0f;
+      auto weights = bernstein<N>(u);
+      auto derivatives = bernsteinDerivative<N>(u);
+      for (size_t k = 0; k < N; ++k) {
+        m_weights[k * samples + j] = weights[k];
+        m_derivatives[k * samples + j] = derivatives[k];
+      }
+    }
+  }
+
+  size_t samples() const noexcept { return m_samples; }
+
+  // weights of the k-th basis function for every sample
+  std::span<const float> basis(size_t k) const noexcept {
+    return std::span<const float>{m_weights}.subspan(k * m_samples, m_samples);
+  }
+
+  // derivative of the k-th basis function for every sample
+  std::span<const float> derivative(size_t k) const noexcept {
+    return std::span<const float>{m_derivatives}.subspan(k * m_samples, m_samples);
+  }
+
+  float operator()(size_t k, size_t sample) const noexcept {
+    return m_weights[k * m_samples + sample];
+  }
+
+  float derivative(size_t k, size_t sample) const noexcept {
+    return m_derivatives[k * m_samples + sample];
+  }
+
+ private:
+  size_t m_samples = 0;
+  std::vector<float> m_weights;
+  std::vector<float> m_derivatives;
+};
+
+// Number of uniform segments needed to approximate a Bezier curve of the given degree within
+// tolerance, from the largest second difference of its control points:
+// error <= degree (degree - 1) max|P_{i-1} - 2 P_i + P_{i+1}| / (8 segments^2)
+inline size_t segmentsForTolerance(size_t degree, float maxSecondDifference, float tolerance) {
+  if (degree < 2 || maxSecondDifference <= 0.0f || tolerance <= 0.0f) {
+    return 1;
+  }
+  float bound = float(degree * (degree - 1)) * maxSecondDifference / (8.0f * tolerance);
+  return std::max<size_t>(1, size_t(std::ceil(std::sqrt(bound))));
+}
+
+// Object space tolerance matching an error of pixels on screen, for geometry at distance from a
+// perspective camera of vertical field of view fovY, in radians, drawing viewportHeight pixels
+inline float screenSpaceTolerance(float pixels, float distance, float fovY,
+                                  float viewportHeight) {
+  return pixels * 2.0f * distance * std::tan(0.5f * fovY) / viewportHeight;
+}
+
+// Splits the Bezier curve defined by N control points at u = 0.5
+template <size_t N>
+inline void subdivide(std::span<const glm::vec3, N> ctrlPoints, std::array<glm::vec3, N>& left,
+                      std::array<glm::vec3, N>& right) {
+  std::array<glm::vec3, N> beta;
+  std::copy(ctrlPoints.begin(), ctrlPoints.end(), beta.begin());
+  left[0] = beta[0];
+  right[N - 1] = beta[N - 1];
+  for (size_t i = 1; i < N; ++i) {
+    for (size_t j = 0; j < N - i; ++j) {
+      beta[j] = (beta[j] + beta[j + 1]) * 0.5f;
+    }
+    left[i] = beta[0];
+    right[N - 1 - i] = beta[N - 1 - i];
+  }
+}
+
+// Largest distance of the inner control points to the segment joining the end points. The curve
+// lies in the convex hull of its control points, so this bounds the distance of the curve to the
+// segment, including the parts of the curve going back or beyond its end points.
+template <size_t N>
+inline float flatness(std::span<const glm::vec3, N> ctrlPoints) {
+  const glm::vec3 chord = ctrlPoints[N - 1] - ctrlPoints[0];
+  const float chordLength2 = glm::dot(chord, chord);
+  float distance = 0.0f;
+  for (size_t i = 1; i + 1 < N; ++i) {
+    const glm::vec3 offset = ctrlPoints[i] - ctrlPoints[0];
+    // closest point of the segment, clamped to its end points
+    const float t =
+        chordLength2 > 0.0f ? std::clamp(glm::dot(offset, chord) / chordLength2, 0.0f, 1.0f)
+                            : 0.0f;
+    distance = std::max(distance, glm::length(offset - t * chord));
+  }
+  return distance;
+}
+
+// Appends the end points of a polyline approximating the Bezier curve within tolerance, the first
+// point of the curve excluded. Flat parts of the curve get fewer segments than curved ones.
+template <size_t N>
+inline void adaptiveDeCasteljau(std::span<const glm::vec3, N> ctrlPoints, float tolerance,
+                                std::vector<glm::vec3>& out, unsigned int maxDepth = 16) {
+  if (maxDepth == 0 || flatness(ctrlPoints) <= tolerance) {
+    out.push_back(ctrlPoints[N - 1]);
+    return;
+  }
+  std::array<glm::vec3, N> left, right;
+  subdivide(ctrlPoints, left, right);
+  adaptiveDeCasteljau(std::span<const glm::vec3, N>{left}, tolerance, out, maxDepth - 1);
+  adaptiveDeCasteljau(std::span<const glm::vec3, N>{right}, tolerance, out, maxDepth - 1);
+}
+
 }  // namespace gk::geometry
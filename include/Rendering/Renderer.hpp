@@ -9,12 +9,21 @@
 #include <memory>
 #include <vector>
 
+#include "GFX/OpenGL/GLRingBuffer.hpp"
 #include "GFX/OpenGL/GLShaderProgram.hpp"
 #include "IO/RessourceManager.hpp"
 #include "Rendering/SceneNodes.hpp"
 #include "Scene.hpp"
 
 namespace gk::rendering {
+
+// Meshes of the last rendered frame
+struct RenderStatistics {
+  size_t drawn = 0;
+  // outside the view frustum
+  size_t culled = 0;
+};
+
 class Renderer {
  public:
   Renderer(std::shared_ptr<io::RessourceManager> assetManager);
@@ -22,16 +31,19 @@ class Renderer {
   void setViewport(int x, int y, int width, int height);
   const Scene& getScene() const;
   Scene& getScene();
-  void renderScene() const;
+  void renderScene();
+  const RenderStatistics& statistics() const noexcept;
   const std::shared_ptr<gfx::gl::ShaderProgram> getProgram(const std::string& name) const;
 
  private:
-  void renderNode(SceneNode* node, const glm::mat4& projection, gfx::FlyingCamera& camera,
-                  std::vector<LightNode*> lights = {}) const;
-
   Scene m_scene{};
   std::shared_ptr<io::RessourceManager> m_ressourceManager;
   float m_aspectRatio;
+  // bone palettes of the skinned meshes, rewritten every frame
+  gfx::gl::RingBuffer m_bonePalettes;
+  // indices of the draw items in the view frustum, reused every frame
+  std::vector<uint32_t> m_visible;
+  RenderStatistics m_statistics;
 };
 
 }  // namespace gk::rendering
@@ -4,40 +4,167 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <glm/glm.hpp>
-#include <map>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <span>
+#include <tuple>
+#include <vector>
 
+#include "Core/SlotMap.hpp"
+#include "Geometry/BVH.hpp"
+#include "Geometry/Bounds.hpp"
 #include "GFX/Material.hpp"
 #include "GFX/PointLight.hpp"
 #include "Rendering/SceneNodes.hpp"
 
 namespace gk::rendering {
 
+// Nodes are stored by value in one slot map per type, so nodes of a type are contiguous and a
+// handle resolves in constant time. Removed nodes leave stale handles behind in the children of
+// other nodes, they resolve to nothing and are skipped.
+// Modify the graph through the scene rather than through the nodes, so that the draw list is
+// compiled again.
 class Scene {
  public:
   Scene();
-  std::optional<CameraNode*> activeCamera() const;
-  SceneNode* root() const;
-  long rootId() const;
-  std::optional<SceneNode*> getNode(long id) const noexcept;
-  long addNode() noexcept;
-  void setActiveCamera(long id);
-  long addCamera(gfx::FlyingCamera&& camera);
-  long addLight(gfx::PointLight&& light, const glm::vec3& position);
-  long addMaterial(gfx::Material&& material);
-  long addMaterialParameter(std::unique_ptr<gfx::MaterialParameters>&& material);
-  long addTexture(const std::span<std::byte> texture, int width, int height);
-  std::optional<long> addMesh(const gk::geometry::Mesh& mesh, long materialId);
-  std::optional<long> addMesh(const gk::animation::SkinnedMesh& mesh, long materialId);
-  void connect(long parentId, long childId);
+  std::optional<CameraNode*> activeCamera();
+  std::optional<const CameraNode*> activeCamera() const;
+  NodeHandle root() const noexcept;
+  std::optional<SceneNode*> getNode(NodeHandle handle) noexcept;
+  std::optional<const SceneNode*> getNode(NodeHandle handle) const noexcept;
+  // nullptr if the handle is stale or refers to another type of node
+  template <typename Node>
+  Node* get(NodeHandle handle) noexcept;
+  template <typename Node>
+  const Node* get(NodeHandle handle) const noexcept;
+  // Every node of a type, contiguous
+  template <typename Node>
+  std::span<Node> nodes() noexcept;
+  template <typename Node>
+  std::span<const Node> nodes() const noexcept;
+  size_t size() const noexcept;
+  // Meshes under the root, compiled on the first call after the graph changed. Their world
+  // transforms are those of the last update.
+  std::span<const DrawItem> drawList();
+  // Computes the world transforms of the nodes whose local transform or the transform of one of
+  // their groups changed since the last update, and refits the bounds of the moved meshes
+  void updateTransforms();
+  // Indices in the draw list of the items whose world bounds intersect the frustum, as of the
+  // last update
+  void cull(const geometry::Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+  NodeHandle addNode();
+  void setActiveCamera(NodeHandle handle);
+  NodeHandle addCamera(gfx::FlyingCamera&& camera);
+  NodeHandle addLight(gfx::PointLight&& light, const glm::vec3& position);
+  NodeHandle addMaterial(gfx::Material&& material);
+  NodeHandle addMaterialParameter(std::unique_ptr<gfx::MaterialParameters>&& material);
+  NodeHandle addTexture(const std::span<std::byte> texture, int width, int height);
+  std::optional<NodeHandle> addMesh(const gk::geometry::Mesh& mesh, NodeHandle material,
+                                    gfx::gl::BufferUsage usage = gfx::gl::STATIC);
+  std::optional<NodeHandle> addMesh(const gk::animation::SkinnedMesh& mesh, NodeHandle material);
+  std::optional<NodeHandle> addMesh(const gk::animation::SkinnedMesh8& mesh, NodeHandle material);
+  std::optional<NodeHandle> addMesh(const gk::animation::SkinnedMesh16& mesh,
+                                    NodeHandle material);
+  void connect(NodeHandle parent, NodeHandle child);
+  void disconnect(NodeHandle parent, NodeHandle child);
+  // Returns false if the node is the root or is already removed
+  bool remove(NodeHandle handle);
 
  private:
-  SceneNode* m_rootNode;
-  long m_counter = 1;
-  std::optional<CameraNode*> m_activeCamera;
-  std::map<long, std::unique_ptr<SceneNode>> m_nodes{};
+  template <typename Node>
+  core::SlotMap<Node>& store() noexcept;
+  template <typename Node>
+  const core::SlotMap<Node>& store() const noexcept;
+  template <typename Node, typename... Args>
+  NodeHandle emplace(Args&&... args);
+  template <typename Mesh>
+  std::optional<NodeHandle> emplaceMesh(const Mesh& mesh, NodeHandle material,
+                                        gfx::gl::BufferUsage usage);
+  void compile();
+  void compileGroup(uint32_t transform);
+  void computeWorlds(bool all);
+
+  std::tuple<core::SlotMap<SceneNode>, core::SlotMap<MeshNode>, core::SlotMap<LightNode>,
+             core::SlotMap<CameraNode>, core::SlotMap<MaterialNode>,
+             core::SlotMap<MaterialParameterNode>, core::SlotMap<TextureNode>>
+      m_stores;
+  NodeHandle m_root;
+  NodeHandle m_activeCamera;
+
+  // A group, mesh or light reached from the root, a node connected under several groups has one
+  // per path. Breadth first, parents come before their children.
+  struct Transform {
+    static constexpr uint32_t kNoParent = std::numeric_limits<uint32_t>::max();
+
+    const SceneNode* node;
+    NodeType type;
+    uint32_t parent;
+    // version of the local transform the world transform was computed with
+    uint32_t version;
+    // lights of a group and of the groups above, m_drawLights[firstLight, firstLight + lightCount)
+    uint32_t firstLight, lightCount;
+  };
+  struct DrawState {
+    uint32_t firstTexture, textureCount, firstLight, lightCount, transform;
+    // leaf of the world bounds and bounds version of the mesh it was computed with
+    uint32_t leaf, boundsVersion;
+  };
+
+  // The arrays are compiled from the graph and keep their capacity when compiled again, so a
+  // stable scene does not allocate. Textures and lights of the draw items are ranges of them.
+  std::vector<Transform> m_transforms;
+  std::vector<glm::mat4> m_worlds;
+  // whether the world transform changed in the running update
+  std::vector<uint8_t> m_worldChanged;
+  std::vector<DrawItem> m_drawItems;
+  std::vector<DrawState> m_drawStates;
+  std::vector<const TextureNode*> m_drawTextures;
+  std::vector<DrawLight> m_drawLights;
+  std::vector<uint32_t> m_drawLightTransforms;
+  geometry::DynamicBVH m_bounds;
+  bool m_graphDirty = true;
 };
 
+template <typename Node>
+core::SlotMap<Node>& Scene::store() noexcept {
+  return std::get<core::SlotMap<Node>>(m_stores);
+}
+
+template <typename Node>
+const core::SlotMap<Node>& Scene::store() const noexcept {
+  return std::get<core::SlotMap<Node>>(m_stores);
+}
+
+template <typename Node>
+Node* Scene::get(NodeHandle handle) noexcept {
+  return handle.type == Node::kType ? store<Node>().get(handle.slot) : nullptr;
+}
+
+template <typename Node>
+const Node* Scene::get(NodeHandle handle) const noexcept {
+  return handle.type == Node::kType ? store<Node>().get(handle.slot) : nullptr;
+}
+
+template <typename Node>
+std::span<Node> Scene::nodes() noexcept {
+  return store<Node>().values();
+}
+
+template <typename Node>
+std::span<const Node> Scene::nodes() const noexcept {
+  return store<Node>().values();
+}
+
+template <typename Node, typename... Args>
+NodeHandle Scene::emplace(Args&&... args) {
+  // the stores may move their nodes, the draw list would point to the old ones
+  m_graphDirty = true;
+  return {Node::kType, store<Node>().emplace(std::forward<Args>(args)...)};
+}
+
 }  // namespace gk::rendering
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
 #include <span>
@@ -13,52 +14,77 @@
 #include "GFX/Material.hpp"
 #include "GFX/MaterialParameters.hpp"
 #include "GFX/OpenGL/GLMesh.hpp"
+#include "GFX/OpenGL/GLRingBuffer.hpp"
 #include "GFX/OpenGL/GLShaderProgram.hpp"
 #include "GFX/OpenGL/GLTexture.hpp"
 #include "GFX/PointLight.hpp"
+#include "Geometry/Bounds.hpp"
 #include "Geometry/Mesh.hpp"
 #include "Animation/SkinnedMesh.hpp"
+#include "Core/SlotMap.hpp"
 
 namespace gk::rendering {
 
 enum class NodeType { eGeneric, eMesh, eTexture, eMaterial, eMaterialParams, eCamera, eLight };
 
+// Reference to a node of a Scene. Nodes of each type are stored in their own array, the type
+// tells which one and the slot handle where. A handle to a removed node is stale and resolves to
+// nothing.
+struct NodeHandle {
+  NodeType type = NodeType::eGeneric;
+  core::SlotHandle slot;
+
+  friend bool operator==(const NodeHandle&, const NodeHandle&) = default;
+};
+
+// Nodes refer to each other through handles, they are moved around when the scene adds or removes
+// nodes of their type
 class SceneNode {
  public:
-  SceneNode(long id);
+  static constexpr NodeType kType = NodeType::eGeneric;
+
+  SceneNode() = default;
   SceneNode(const SceneNode&) = delete;
   SceneNode(SceneNode&&) = default;
   SceneNode& operator=(const SceneNode&) = delete;
   SceneNode& operator=(SceneNode&&) = default;
 
   virtual ~SceneNode() {}
-  const std::span<SceneNode* const> children() const noexcept;
-  long id() const noexcept;
+  std::span<const NodeHandle> children() const noexcept;
+
+  virtual void connect(NodeHandle node) noexcept;
+  virtual void disconnect(NodeHandle node) noexcept;
 
-  virtual NodeType nodeType() const;
-  virtual void connect(SceneNode* node) noexcept;
-  virtual void disconnect(long id) noexcept;
+  // Transform relative to the parent group, the scene computes the world transforms
+  const glm::mat4& localTransform() const noexcept;
+  void setLocalTransform(const glm::mat4& transform) noexcept;
+  void translate(const glm::vec3& translation) noexcept;
+  void rotate(float angle, const glm::vec3& axis) noexcept;
+  // Incremented by every change of the local transform
+  uint32_t transformVersion() const noexcept;
 
  protected:
-  SceneNode* m_parent = nullptr;
-  std::vector<SceneNode*> m_children;
+  std::vector<NodeHandle> m_children;
 
  private:
-  long m_id;
+  glm::mat4 m_localTransform{1.0f};
+  uint32_t m_transformVersion = 0;
 };
 
 class LightNode : public SceneNode {
  public:
-  LightNode(long id, gfx::PointLight&& light, const glm::vec3& position);
+  static constexpr NodeType kType = NodeType::eLight;
+
+  LightNode(gfx::PointLight&& light, const glm::vec3& position);
   LightNode(const LightNode&) = delete;
   LightNode(LightNode&&) = default;
   LightNode& operator=(const LightNode&) = delete;
   LightNode& operator=(LightNode&&) = default;
 
-  NodeType nodeType() const override;
   const gfx::PointLight& light() const;
   gfx::PointLight& light();
 
+  // in the frame of the node, moved with its transform
   const glm::vec3& position() const;
   void setPosition(const glm::vec3& position) noexcept;
 
@@ -69,7 +95,9 @@ class LightNode : public SceneNode {
 
 class CameraNode : public SceneNode {
  public:
-  CameraNode(long id, gfx::FlyingCamera&& cam);
+  static constexpr NodeType kType = NodeType::eCamera;
+
+  CameraNode(gfx::FlyingCamera&& cam);
   CameraNode(const CameraNode&) = delete;
   CameraNode(CameraNode&&) = default;
   CameraNode& operator=(const CameraNode&) = delete;
@@ -78,19 +106,17 @@ class CameraNode : public SceneNode {
   const gfx::FlyingCamera& camera() const;
   gfx::FlyingCamera& camera();
 
-  NodeType nodeType() const override;
-
  private:
-  SceneNode* parent = nullptr;
   std::unique_ptr<gfx::FlyingCamera> m_camera;
 };
 
 class MaterialNode : public SceneNode {
  public:
-  MaterialNode(long id, gfx::Material&& material);
+  static constexpr NodeType kType = NodeType::eMaterial;
+
+  MaterialNode(gfx::Material&& material);
   void setParameters() const;
   void setupLights() const;
-  NodeType nodeType() const override;
 
   gfx::gl::ShaderProgram& program() const noexcept;
 
@@ -100,10 +126,11 @@ class MaterialNode : public SceneNode {
 
 class MaterialParameterNode : public SceneNode {
  public:
-  MaterialParameterNode(long id);
-  MaterialParameterNode(long id, std::unique_ptr<gfx::MaterialParameters>&& material);
+  static constexpr NodeType kType = NodeType::eMaterialParams;
+
+  MaterialParameterNode();
+  MaterialParameterNode(std::unique_ptr<gfx::MaterialParameters>&& material);
 
-  NodeType nodeType() const override;
   const gfx::MaterialParameters* parameters() const;
   gfx::MaterialParameters* parameters();
 
@@ -113,17 +140,19 @@ class MaterialParameterNode : public SceneNode {
 
 class TextureNode : public SceneNode {
  public:
-  TextureNode(long id, const std::span<std::byte> texture, int width, int height);
+  static constexpr NodeType kType = NodeType::eTexture;
+
+  TextureNode(const std::span<std::byte> texture, int width, int height);
 
   TextureNode(const TextureNode&) = delete;
+  TextureNode(TextureNode&&) = default;
 
   TextureNode& operator=(const TextureNode&) = delete;
+  TextureNode& operator=(TextureNode&&) = default;
 
   void update(const std::span<std::byte> texture, int width, int height) noexcept;
 
-  void bind() noexcept;
-
-  NodeType nodeType() const override;
+  void bind() const noexcept;
 
   const gfx::gl::Texture& texture() const noexcept;
 
@@ -131,42 +160,80 @@ class TextureNode : public SceneNode {
   std::unique_ptr<gfx::gl::Texture> m_tex;
 };
 
+class MeshNode;
+
+// A light of the groups above a mesh and its world transform
+struct DrawLight {
+  const LightNode* node = nullptr;
+  const glm::mat4* world = nullptr;
+};
+
+// A mesh with the nodes connected to it and the lights of its groups, resolved by the scene when
+// the graph changes. The pointers and spans are valid until the scene is modified.
+struct DrawItem {
+  const MeshNode* mesh = nullptr;
+  const MaterialNode* material = nullptr;
+  const MaterialParameterNode* parameters = nullptr;
+  std::span<const TextureNode* const> textures;
+  std::span<const DrawLight> lights;
+  const glm::mat4* world = nullptr;
+};
+
+// The vertex layout of the mesh is set up for the program of the material it is created with, the
+// material used to draw it is the one connected to it
 class MeshNode : public SceneNode {
  public:
-  MeshNode(long id, const gk::geometry::Mesh& mesh, MaterialNode* material);
-  MeshNode(long id, const gk::animation::SkinnedMesh& mesh, MaterialNode* material);
+  static constexpr NodeType kType = NodeType::eMesh;
+
+  MeshNode(const gk::geometry::Mesh& mesh, const MaterialNode& material,
+           gfx::gl::BufferUsage usage = gfx::gl::STATIC);
+  MeshNode(const gk::animation::SkinnedMesh& mesh, const MaterialNode& material);
+  MeshNode(const gk::animation::SkinnedMesh8& mesh, const MaterialNode& material);
+  MeshNode(const gk::animation::SkinnedMesh16& mesh, const MaterialNode& material);
 
   MeshNode(const MeshNode&) = delete;
+  MeshNode(MeshNode&&) = default;
 
   MeshNode& operator=(const MeshNode&) = delete;
+  MeshNode& operator=(MeshNode&&) = default;
 
-  void connect(SceneNode* node) noexcept override;
+  void connect(NodeHandle node) noexcept override;
 
-  void disconnect(long id) noexcept override;
+  void disconnect(NodeHandle node) noexcept override;
 
-  void draw(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix,
-            const glm::vec3& cameraPosition, const std::vector<LightNode*> lights) const;
+  // Draws with the nodes of item, the draw item of this mesh. The bone palette of skinned meshes
+  // is written to bonePalettes and its range bound for the draw.
+  void draw(const DrawItem& item, const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix,
+            const glm::vec3& cameraPosition, gfx::gl::RingBuffer& bonePalettes) const;
 
   void update(const gk::geometry::Mesh& mesh);
+  void update(const gk::geometry::Mesh& mesh, gk::geometry::VertexRange range);
+  // Replaces the vertices only, e.g. with the output of CPU skinning each frame
+  void update(std::span<const gk::geometry::Mesh::Vertex> vertices);
 
-  NodeType nodeType() const override;
-
-  std::vector<std::shared_ptr<gfx::gl::Texture>>& textures() noexcept;
+  NodeHandle material() const noexcept;
+  NodeHandle parameters() const noexcept;
+  std::span<const NodeHandle> textures() const noexcept;
 
   bool hasMaterial() const noexcept;
   bool hasTextures() const noexcept;
 
-  void translate(const glm::vec3& translation) noexcept;
-  void rotate(float angle, const glm::vec3& axis) noexcept;
-
-  const std::span<const std::shared_ptr<gfx::gl::Texture>> textures() const noexcept;
+  // In the frame of the node. Skinned meshes are bounded in their bind pose, the scene moves that
+  // box with the skinning matrices of their parameters at every update to cull them.
+  const geometry::AABB& bounds() const noexcept;
+  void setBounds(const geometry::AABB& bounds) noexcept;
+  bool skinned() const noexcept;
+  // Incremented by every change of the bounds
+  uint32_t boundsVersion() const noexcept;
 
  private:
   std::unique_ptr<gfx::gl::Mesh> m_mesh;
-  MaterialNode* m_material = nullptr;
-  MaterialParameterNode* m_params = nullptr;
-  std::vector<TextureNode*> m_textures;
-  glm::mat4 m_modelMatrix = glm::mat4(1.0f);
+  NodeHandle m_material;
+  NodeHandle m_params;
+  std::vector<NodeHandle> m_textures;
+  geometry::AABB m_bounds;
+  uint32_t m_boundsVersion = 0;
+  bool m_skinned = false;
 };
 
 }  // namespace gk::rendering
@@ -0,0 +1,65 @@
+#version 450 core
+
+#define VERTEX_BONES 4
+
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec2 in_uv;
+layout(location = 3) in int in_bone_count;
+layout(location = 4) in ivec4 in_bone_idx;
+layout(location = 5) in vec4 in_bone_weights;
+
+layout(location = 0) out vec3 position_world;
+layout(location = 1) out vec3 normal;
+layout(location = 2) out vec2 uv;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+// inverse transpose of the model matrix, computed once per draw
+uniform mat3 normal_matrix;
+
+// unit dual quaternion of each bone, parts stored as (x, y, z, w)
+struct DualQuat {
+    vec4 real;
+    vec4 dual;
+};
+
+// a range of the palette buffer bound for each mesh
+layout(std430, binding = 0) readonly buffer BonePalette {
+    DualQuat bones[];
+};
+
+vec3 rotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main() {
+    vec4 real = vec4(0.0);
+    vec4 dual = vec4(0.0);
+    vec4 first = bones[in_bone_idx[0]].real;
+
+    for(int i = 0; i < in_bone_count; ++i) {
+        if(in_bone_weights[i] == 0.0)
+            continue;
+        vec4 bone_real = bones[in_bone_idx[i]].real;
+        vec4 bone_dual = bones[in_bone_idx[i]].dual;
+        // q and -q are the same rotation, blend along the shortest path
+        float weight = dot(first, bone_real) < 0.0 ? -in_bone_weights[i] : in_bone_weights[i];
+        real += bone_real * weight;
+        dual += bone_dual * weight;
+    }
+
+    float norm = length(real);
+    real /= norm;
+    dual /= norm;
+
+    vec3 translation = 2.0 * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+    vec3 position = rotate(real, in_position) + translation;
+
+    vec4 pos_world = model * vec4(position, 1.0);
+    position_world = vec3(pos_world);
+    normal = normalize(normal_matrix * rotate(real, in_normal));
+    uv = in_uv;
+    gl_Position = projection * view * pos_world;
+}
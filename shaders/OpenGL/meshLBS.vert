@@ -1,6 +1,5 @@
 #version 450 core
 
-#define MAX_BONES 100
 #define VERTEX_BONES 4
 
 layout(location = 0) in vec3 in_position;
@@ -17,8 +16,13 @@ layout(location = 2) out vec2 uv;
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+// inverse transpose of the model matrix, computed once per draw
+uniform mat3 normal_matrix;
 
-uniform mat4 bones[MAX_BONES];
+// skinning matrices of the skeleton, a range of the palette buffer bound for each mesh
+layout(std430, binding = 0) readonly buffer BonePalette {
+    mat4 bones[];
+};
 
 void main() {
     vec4 final_position = vec4(0.0);
@@ -37,7 +41,7 @@ void main() {
 
     vec4 pos_world = model * final_position;
     position_world = vec3(pos_world);
-    normal = mat3(transpose(inverse(model))) * vec3(final_normal);
+    normal = normal_matrix * vec3(final_normal);
     uv = in_uv;
     gl_Position = projection * view * pos_world;
 }
@@ -0,0 +1,46 @@
+#version 450 core
+
+#define VERTEX_BONES 4
+
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec2 in_uv;
+// 8 bits indices, unused influences have a zero weight
+layout(location = 3) in uvec4 in_bone_idx;
+// normalised 8 or 16 bits weights
+layout(location = 4) in vec4 in_bone_weights;
+
+layout(location = 0) out vec3 position_world;
+layout(location = 1) out vec3 normal;
+layout(location = 2) out vec2 uv;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+// inverse transpose of the model matrix, computed once per draw
+uniform mat3 normal_matrix;
+
+// skinning matrices of the skeleton, a range of the palette buffer bound for each mesh
+layout(std430, binding = 0) readonly buffer BonePalette {
+    mat4 bones[];
+};
+
+void main() {
+    vec4 final_position = vec4(0.0);
+    vec4 final_normal = vec4(0.0);
+
+    for(int i = 0; i < VERTEX_BONES; ++i) {
+        if(in_bone_weights[i] == 0.0)
+            continue;
+        mat4 bone = bones[in_bone_idx[i]];
+        final_position += bone * vec4(in_position, 1.0) * in_bone_weights[i];
+        final_normal += (bone * vec4(in_normal, 0.0)) * in_bone_weights[i];
+    }
+    final_normal = normalize(final_normal);
+
+    vec4 pos_world = model * final_position;
+    position_world = vec3(pos_world);
+    normal = normal_matrix * vec3(final_normal);
+    uv = in_uv;
+    gl_Position = projection * view * pos_world;
+}
@@ -0,0 +1,129 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Animation/AnimationSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace gk::animation {
+
+AnimationSystem::AnimationSystem(core::ThreadPool& pool) : m_pool(pool) {}
+
+size_t AnimationSystem::add(Skeleton& skeleton, const Clip& clip, float speed, bool loop) {
+  // two instances of the same skeleton would write its pose concurrently in update
+  if (!m_skeletons.insert(&skeleton).second) {
+    throw std::invalid_argument("The skeleton is already played by an instance");
+  }
+  const size_t bones = skeleton.size();
+  Instance instance;
+  instance.skeleton = &skeleton;
+  instance.clip = &clip;
+  instance.cursor = clip.cursor();
+  instance.speed = speed;
+  instance.loop = loop;
+  instance.paletteOffset = m_palettes.size();
+  instance.nbBones = bones;
+  instance.nextPose.resize(bones);
+  m_palettes.resize(m_palettes.size() + bones, glm::mat4(1.0f));
+  m_instances.push_back(std::move(instance));
+  return m_instances.size() - 1;
+}
+
+size_t AnimationSystem::add(Skeleton& skeleton, const Clip& clip, const RetargetMap& retarget,
+                            float speed, bool loop) {
+  const size_t index = add(skeleton, clip, speed, loop);
+  Instance& instance = m_instances[index];
+  instance.retarget = &retarget;
+  instance.sourcePose = retarget.sourceBindPose();
+  instance.nextPose.resize(retarget.sourceSize());
+  return index;
+}
+
+size_t AnimationSystem::size() const noexcept { return m_instances.size(); }
+
+void AnimationSystem::setClip(size_t instance, const Clip& clip) {
+  Instance& i = m_instances.at(instance);
+  i.clip = &clip;
+  i.cursor = clip.cursor();
+  i.time = 0.0f;
+  i.next = nullptr;
+}
+
+void AnimationSystem::crossFade(size_t instance, const Clip& clip, float duration) {
+  Instance& i = m_instances.at(instance);
+  i.next = &clip;
+  i.nextCursor = clip.cursor();
+  i.nextTime = 0.0f;
+  i.fade = 0.0f;
+  i.fadeDuration = duration;
+}
+
+void AnimationSystem::setTime(size_t instance, float time) { m_instances.at(instance).time = time; }
+
+void AnimationSystem::setSpeed(size_t instance, float speed) {
+  m_instances.at(instance).speed = speed;
+}
+
+namespace {
+
+float advanceTime(float time, float elapsed, float duration, bool loop) {
+  time += elapsed;
+  if (loop && duration > 0.0f) {
+    return time - duration * std::floor(time / duration);
+  }
+  return std::clamp(time, 0.0f, duration);
+}
+
+}  // namespace
+
+void AnimationSystem::update(float elapsed) {
+  // skeletons are small, a chunk of instances amortises the scheduling of the pool
+  constexpr size_t grain = 16;
+  m_pool.parallelFor(m_instances.size(), grain, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      Instance& instance = m_instances[i];
+      const float step = elapsed * instance.speed;
+      instance.time = advanceTime(instance.time, step, instance.clip->duration(), instance.loop);
+      Pose& pose = instance.retarget ? instance.sourcePose : instance.skeleton->editPose();
+      instance.clip->sample(instance.time, instance.cursor, pose);
+
+      if (instance.next != nullptr) {
+        instance.nextTime =
+            advanceTime(instance.nextTime, step, instance.next->duration(), instance.loop);
+        instance.fade += elapsed;
+        // bones without a track in the next clip keep the current pose
+        instance.nextPose = pose;
+        instance.next->sample(instance.nextTime, instance.nextCursor, instance.nextPose);
+        float weight =
+            instance.fadeDuration > 0.0f ? instance.fade / instance.fadeDuration : 1.0f;
+        blend(pose, instance.nextPose, std::min(weight, 1.0f), pose);
+
+        if (weight >= 1.0f) {
+          instance.clip = instance.next;
+          std::swap(instance.cursor, instance.nextCursor);
+          instance.time = instance.nextTime;
+          instance.next = nullptr;
+        }
+      }
+      if (instance.retarget) {
+        instance.retarget->apply(pose, instance.skeleton->editPose());
+      }
+
+      auto skinning = instance.skeleton->skinningMatrices();
+      std::copy_n(skinning.begin(), instance.nbBones, m_palettes.begin() + instance.paletteOffset);
+    }
+  });
+}
+
+std::span<const glm::mat4> AnimationSystem::palette(size_t instance) const {
+  const Instance& i = m_instances.at(instance);
+  return std::span<const glm::mat4>{m_palettes}.subspan(i.paletteOffset, i.nbBones);
+}
+
+std::span<const glm::mat4> AnimationSystem::palettes() const noexcept { return m_palettes; }
+
+}  // namespace gk::animation
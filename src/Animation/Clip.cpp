@@ -0,0 +1,161 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Animation/Clip.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/quaternion.hpp>
+#include <stdexcept>
+
+namespace gk::animation {
+
+namespace {
+
+int16_t packComponent(float value) {
+  return int16_t(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+glm::quat unpack(const std::array<int16_t, 4>& packed) {
+  constexpr float scale = 1.0f / 32767.0f;
+  return glm::quat(float(packed[3]) * scale, float(packed[0]) * scale, float(packed[1]) * scale,
+                   float(packed[2]) * scale);
+}
+
+// Moves the key of the track forward until the next one is after time, and returns the
+// interpolation factor between both
+float advance(std::span<const float> times, uint32_t& key, float time) {
+  if (times.size() < 2) {
+    key = 0;
+    return 0.0f;
+  }
+  // the track may have been replaced by a shorter one since the cursor moved
+  key = std::min<uint32_t>(key, uint32_t(times.size() - 2));
+  while (key + 2 < times.size() && times[key + 1] <= time) {
+    ++key;
+  }
+  const float span = times[key + 1] - times[key];
+  return span > 0.0f ? std::clamp((time - times[key]) / span, 0.0f, 1.0f) : 0.0f;
+}
+
+// Linear interpolation of the translation or scale channel of a clip
+template <typename Channel>
+void sampleVectors(const Channel& channel, uint32_t* keys, float time, std::span<glm::vec3> out) {
+  for (size_t b = 0; b < out.size(); ++b) {
+    const auto& track = channel.tracks[b];
+    if (track.count == 0) continue;
+    auto times = std::span{channel.times}.subspan(track.first, track.count);
+    float t = advance(times, keys[b], time);
+    const glm::vec3* values = channel.values.data() + track.first + keys[b];
+    out[b] = track.count > 1 ? glm::mix(values[0], values[1], t) : values[0];
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void Clip::Channel<T>::set(int bone, std::span<const float> newTimes,
+                          std::span<const T> newValues) {
+  if (newTimes.size() != newValues.size()) {
+    throw std::invalid_argument("a track needs one value per key");
+  }
+
+  // drop the previous keys of the bone, the following tracks move back
+  Track& track = tracks[bone];
+  times.erase(times.begin() + track.first, times.begin() + track.first + track.count);
+  values.erase(values.begin() + track.first, values.begin() + track.first + track.count);
+  for (auto& other : tracks) {
+    if (other.first > track.first) other.first -= track.count;
+  }
+
+  track.first = times.size();
+  track.count = newTimes.size();
+  times.insert(times.end(), newTimes.begin(), newTimes.end());
+  values.insert(values.end(), newValues.begin(), newValues.end());
+}
+
+Clip::Clip(float duration, int nbBones) : m_duration(duration), m_nbBones(nbBones) {
+  m_translations.tracks.resize(nbBones);
+  m_rotations.tracks.resize(nbBones);
+  m_scales.tracks.resize(nbBones);
+}
+
+float Clip::duration() const noexcept { return m_duration; }
+
+int Clip::nbBones() const noexcept { return m_nbBones; }
+
+void Clip::setTranslations(int bone, std::span<const float> times,
+                           std::span<const glm::vec3> translations) {
+  if (bone < 0 || bone >= m_nbBones) {
+    throw std::out_of_range("Index out of range");
+  }
+  m_translations.set(bone, times, translations);
+}
+
+void Clip::setRotations(int bone, std::span<const float> times,
+                        std::span<const glm::quat> rotations) {
+  if (bone < 0 || bone >= m_nbBones) {
+    throw std::out_of_range("Index out of range");
+  }
+  std::vector<PackedQuat> packed(rotations.size());
+  glm::quat previous(1.0f, 0.0f, 0.0f, 0.0f);
+  for (size_t i = 0; i < rotations.size(); ++i) {
+    glm::quat q = glm::normalize(rotations[i]);
+    // keep consecutive keys in the same hemisphere so the interpolation takes the shortest path
+    if (i > 0 && glm::dot(previous, q) < 0.0f) {
+      q = -q;
+    }
+    previous = q;
+    packed[i] = {packComponent(q.x), packComponent(q.y), packComponent(q.z), packComponent(q.w)};
+  }
+  m_rotations.set(bone, times, std::span<const PackedQuat>{packed});
+}
+
+void Clip::setScales(int bone, std::span<const float> times, std::span<const glm::vec3> scales) {
+  if (bone < 0 || bone >= m_nbBones) {
+    throw std::out_of_range("Index out of range");
+  }
+  m_scales.set(bone, times, scales);
+}
+
+Clip::Cursor Clip::cursor() const { return {std::vector<uint32_t>(3 * m_nbBones, 0), 0.0f}; }
+
+void Clip::sample(float time, Cursor& cursor, Pose& pose) const {
+  time = std::clamp(time, 0.0f, m_duration);
+  // a cursor of another clip, or a default constructed one, starts over
+  if (cursor.keys.size() != 3 * size_t(m_nbBones)) {
+    cursor.keys.assign(3 * size_t(m_nbBones), 0);
+  } else if (time < cursor.time) {
+    std::fill(cursor.keys.begin(), cursor.keys.end(), 0);
+  }
+  cursor.time = time;
+
+  const size_t bones = std::min<size_t>(m_nbBones, pose.size());
+  uint32_t* translationKeys = cursor.keys.data();
+  uint32_t* rotationKeys = translationKeys + m_nbBones;
+  uint32_t* scaleKeys = rotationKeys + m_nbBones;
+
+  sampleVectors(m_translations, translationKeys, time,
+                std::span<glm::vec3>{pose.translations}.first(bones));
+  sampleVectors(m_scales, scaleKeys, time, std::span<glm::vec3>{pose.scales}.first(bones));
+
+  for (size_t b = 0; b < bones; ++b) {
+    const Track& track = m_rotations.tracks[b];
+    if (track.count == 0) continue;
+    auto times = std::span{m_rotations.times}.subspan(track.first, track.count);
+    float t = advance(times, rotationKeys[b], time);
+    const PackedQuat* values = m_rotations.values.data() + track.first + rotationKeys[b];
+    glm::quat q = unpack(values[0]);
+    if (track.count > 1) {
+      q = q * (1.0f - t) + unpack(values[1]) * t;
+    }
+    pose.rotations[b] = glm::normalize(q);
+  }
+}
+
+void Clip::sample(float time, Cursor& cursor, Skeleton& skeleton) const {
+  sample(time, cursor, skeleton.editPose());
+}
+
+}  // namespace gk::animation
@@ -0,0 +1,224 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Animation/CpuSkinning.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+// The AVX2 kernel is compiled for its own target and picked at run time on the CPUs supporting
+// it, the rest of the library keeps the baseline instruction set
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GK_SKINNING_AVX2 1
+#ifdef __SSE2__
+#define GK_SKINNING_SSE2 1
+#else
+#define GK_SKINNING_SSE2 0
+#endif
+#elif defined(_M_X64)
+#include <emmintrin.h>
+#define GK_SKINNING_AVX2 0
+#define GK_SKINNING_SSE2 1
+#else
+#define GK_SKINNING_AVX2 0
+#define GK_SKINNING_SSE2 0
+#endif
+
+namespace gk::animation {
+
+namespace {
+
+bool validBone(int bone, size_t paletteSize) { return bone >= 0 && size_t(bone) < paletteSize; }
+
+// SkinnedMesh has no tangents to skin, every vertex gets this one
+const glm::vec4 kPlaceholderTangent(1.0f, 0.0f, 0.0f, 1.0f);
+
+// A vertex without any influence in the palette would be crushed at the origin with a zero
+// normal, it stays in its bind pose instead
+void bindPose(const SkinnedMesh::Vertex& in, geometry::Mesh::Vertex& out) {
+  out.position = in.position;
+  out.normal = in.normal;
+  out.uv = in.uv;
+  out.tangent = kPlaceholderTangent;
+}
+
+using Kernel = void (*)(std::span<const SkinnedMesh::Vertex>, std::span<const glm::mat4>,
+                       std::span<geometry::Mesh::Vertex>);
+
+#if GK_SKINNING_AVX2
+
+// The blended matrix is kept as two registers holding columns 0 | 1 and 2 | 3, so a vertex is
+// transformed with two multiply-adds and a fold of the halves
+__attribute__((target("avx2,fma"))) void skinRangeAvx2(
+    std::span<const SkinnedMesh::Vertex> vertices, std::span<const glm::mat4> palette,
+    std::span<geometry::Mesh::Vertex> out) {
+  for (size_t v = 0; v < vertices.size(); ++v) {
+    const auto& in = vertices[v];
+    __m256 c01 = _mm256_setzero_ps();
+    __m256 c23 = _mm256_setzero_ps();
+    float total = 0.0f;
+    const int count = std::min(in.boneCount, 4);
+    for (int i = 0; i < count; ++i) {
+      const int bone = in.boneIdx[i];
+      const float weight = in.boneWeights[i];
+      if (weight == 0.0f || !validBone(bone, palette.size())) continue;
+      total += weight;
+      const float* m = &palette[bone][0][0];
+      const __m256 w = _mm256_set1_ps(weight);
+      c01 = _mm256_fmadd_ps(_mm256_loadu_ps(m), w, c01);
+      c23 = _mm256_fmadd_ps(_mm256_loadu_ps(m + 8), w, c23);
+    }
+    if (total == 0.0f) {
+      bindPose(in, out[v]);
+      continue;
+    }
+
+    const __m256 xy = _mm256_setr_ps(in.position.x, in.position.x, in.position.x, in.position.x,
+                                     in.position.y, in.position.y, in.position.y, in.position.y);
+    const __m256 z1 = _mm256_setr_ps(in.position.z, in.position.z, in.position.z, in.position.z,
+                                     1.0f, 1.0f, 1.0f, 1.0f);
+    const __m256 p = _mm256_fmadd_ps(c01, xy, _mm256_mul_ps(c23, z1));
+    const __m128 position = _mm_add_ps(_mm256_castps256_ps128(p), _mm256_extractf128_ps(p, 1));
+
+    const __m256 nxy = _mm256_setr_ps(in.normal.x, in.normal.x, in.normal.x, in.normal.x,
+                                      in.normal.y, in.normal.y, in.normal.y, in.normal.y);
+    const __m256 nz0 = _mm256_setr_ps(in.normal.z, in.normal.z, in.normal.z, in.normal.z, 0.0f,
+                                      0.0f, 0.0f, 0.0f);
+    const __m256 n = _mm256_fmadd_ps(c01, nxy, _mm256_mul_ps(c23, nz0));
+    const __m128 normal = _mm_add_ps(_mm256_castps256_ps128(n), _mm256_extractf128_ps(n, 1));
+
+    alignas(16) float pos[4];
+    alignas(16) float nor[4];
+    _mm_store_ps(pos, position);
+    _mm_store_ps(nor, normal);
+    out[v].position = glm::vec3(pos[0], pos[1], pos[2]);
+    out[v].normal = glm::normalize(glm::vec3(nor[0], nor[1], nor[2]));
+    out[v].uv = in.uv;
+    out[v].tangent = kPlaceholderTangent;
+  }
+}
+
+#endif
+
+#if GK_SKINNING_SSE2
+
+// One register per column of the blended matrix
+void skinRangeSse2(std::span<const SkinnedMesh::Vertex> vertices,
+                   std::span<const glm::mat4> palette, std::span<geometry::Mesh::Vertex> out) {
+  for (size_t v = 0; v < vertices.size(); ++v) {
+    const auto& in = vertices[v];
+    __m128 c0 = _mm_setzero_ps();
+    __m128 c1 = _mm_setzero_ps();
+    __m128 c2 = _mm_setzero_ps();
+    __m128 c3 = _mm_setzero_ps();
+    float total = 0.0f;
+    const int count = std::min(in.boneCount, 4);
+    for (int i = 0; i < count; ++i) {
+      const int bone = in.boneIdx[i];
+      const float weight = in.boneWeights[i];
+      if (weight == 0.0f || !validBone(bone, palette.size())) continue;
+      total += weight;
+      const float* m = &palette[bone][0][0];
+      const __m128 w = _mm_set1_ps(weight);
+      c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(m), w));
+      c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(m + 4), w));
+      c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(m + 8), w));
+      c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(m + 12), w));
+    }
+    if (total == 0.0f) {
+      bindPose(in, out[v]);
+      continue;
+    }
+
+    const __m128 position = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(in.position.x)),
+                   _mm_mul_ps(c1, _mm_set1_ps(in.position.y))),
+        _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(in.position.z)), c3));
+    const __m128 normal = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(in.normal.x)),
+                                                _mm_mul_ps(c1, _mm_set1_ps(in.normal.y))),
+                                     _mm_mul_ps(c2, _mm_set1_ps(in.normal.z)));
+
+    alignas(16) float pos[4];
+    alignas(16) float nor[4];
+    _mm_store_ps(pos, position);
+    _mm_store_ps(nor, normal);
+    out[v].position = glm::vec3(pos[0], pos[1], pos[2]);
+    out[v].normal = glm::normalize(glm::vec3(nor[0], nor[1], nor[2]));
+    out[v].uv = in.uv;
+    out[v].tangent = kPlaceholderTangent;
+  }
+}
+
+#endif
+
+void skinRangeScalar(std::span<const SkinnedMesh::Vertex> vertices,
+                     std::span<const glm::mat4> palette, std::span<geometry::Mesh::Vertex> out) {
+  for (size_t v = 0; v < vertices.size(); ++v) {
+    const auto& in = vertices[v];
+    glm::mat4 skinning(0.0f);
+    float total = 0.0f;
+    const int count = std::min(in.boneCount, 4);
+    for (int i = 0; i < count; ++i) {
+      const int bone = in.boneIdx[i];
+      const float weight = in.boneWeights[i];
+      if (weight == 0.0f || !validBone(bone, palette.size())) continue;
+      total += weight;
+      skinning = skinning + palette[bone] * weight;
+    }
+    if (total == 0.0f) {
+      bindPose(in, out[v]);
+      continue;
+    }
+    out[v].position = glm::vec3(skinning * glm::vec4(in.position, 1.0f));
+    out[v].normal = glm::normalize(glm::vec3(skinning * glm::vec4(in.normal, 0.0f)));
+    out[v].uv = in.uv;
+    out[v].tangent = kPlaceholderTangent;
+  }
+}
+
+Kernel selectKernel() {
+#if GK_SKINNING_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return skinRangeAvx2;
+  }
+#endif
+#if GK_SKINNING_SSE2
+  return skinRangeSse2;
+#else
+  return skinRangeScalar;
+#endif
+}
+
+// Selected once, the CPU does not change while running
+void skinRange(std::span<const SkinnedMesh::Vertex> vertices, std::span<const glm::mat4> palette,
+               std::span<geometry::Mesh::Vertex> out) {
+  static const Kernel kernel = selectKernel();
+  kernel(vertices, palette, out);
+}
+
+}  // namespace
+
+void skinVerticesScalar(std::span<const SkinnedMesh::Vertex> vertices,
+                        std::span<const glm::mat4> palette, std::span<geometry::Mesh::Vertex> out) {
+  skinRangeScalar(vertices, palette, out);
+}
+
+void skinVertices(std::span<const SkinnedMesh::Vertex> vertices,
+                  std::span<const glm::mat4> palette, std::span<geometry::Mesh::Vertex> out) {
+  skinRange(vertices, palette, out);
+}
+
+void skinVertices(std::span<const SkinnedMesh::Vertex> vertices,
+                  std::span<const glm::mat4> palette, std::span<geometry::Mesh::Vertex> out,
+                  core::ThreadPool& pool) {
+  // large enough chunks for each thread to stream through memory
+  constexpr size_t grain = 4096;
+  pool.parallelFor(vertices.size(), grain, [&](size_t begin, size_t end) {
+    skinRange(vertices.subspan(begin, end - begin), palette, out.subspan(begin, end - begin));
+  });
+}
+
+}  // namespace gk::animation
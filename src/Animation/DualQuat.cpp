@@ -0,0 +1,35 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Animation/DualQuat.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace gk::animation {
+
+DualQuat toDualQuat(const glm::mat4& transform) {
+  // normalise the axes so that a scaled matrix still gives a unit rotation
+  const glm::mat3 rotation(glm::normalize(glm::vec3(transform[0])),
+                           glm::normalize(glm::vec3(transform[1])),
+                           glm::normalize(glm::vec3(transform[2])));
+  const glm::quat real = glm::normalize(glm::quat_cast(rotation));
+  const glm::vec3 t(transform[3]);
+  const glm::quat dual = glm::quat(0.0f, t.x, t.y, t.z) * real * 0.5f;
+  return {real, dual};
+}
+
+void toDualQuats(std::span<const glm::mat4> transforms, std::span<DualQuat> out) {
+  for (size_t i = 0; i < transforms.size(); ++i) {
+    out[i] = toDualQuat(transforms[i]);
+  }
+}
+
+glm::vec3 transformPoint(const DualQuat& dq, const glm::vec3& point) {
+  const glm::vec3 r(dq.real.x, dq.real.y, dq.real.z);
+  const glm::vec3 d(dq.dual.x, dq.dual.y, dq.dual.z);
+  const glm::vec3 translation = 2.0f * (dq.real.w * d - dq.dual.w * r + glm::cross(r, d));
+  return dq.real * point + translation;
+}
+
+}  // namespace gk::animation
@@ -0,0 +1,232 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Animation/IK.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace gk::animation {
+
+namespace {
+
+constexpr float kEpsilon = 1e-6f;
+
+// State of the skeleton shared by every chain of a batch. The global transforms are computed once
+// before any rotation changes, and stay untouched while the chains write to the pose.
+struct Frame {
+  std::span<const glm::mat4> globals;
+  std::span<const int> parents;
+  std::span<const glm::mat4> inverseBinds;
+  std::span<const glm::vec3> joints;
+  Pose& pose;
+};
+
+Frame snapshot(Skeleton& skeleton) {
+  const auto globals = skeleton.globalTransforms();
+  return {globals, skeleton.parents(), skeleton.inverseBindMatrices(), skeleton.bindJoints(),
+          skeleton.editPose()};
+}
+
+bool validChain(const Frame& frame, std::span<const int> bones) {
+  if (bones.empty() || bones.size() > IkChain::kMaxBones) return false;
+  for (size_t k = 0; k < bones.size(); ++k) {
+    if (bones[k] < 0 || size_t(bones[k]) >= frame.parents.size()) return false;
+    if (k > 0 && frame.parents[bones[k]] != bones[k - 1]) return false;
+  }
+  return true;
+}
+
+// Unit vector from a to b, zero when they are the same point
+glm::vec3 direction(const glm::vec3& a, const glm::vec3& b) {
+  const glm::vec3 d = b - a;
+  const float length = glm::length(d);
+  return length < kEpsilon ? glm::vec3(0.0f) : d / length;
+}
+
+glm::quat rotationOf(const glm::mat4& transform) {
+  const glm::mat3 rotation(glm::normalize(glm::vec3(transform[0])),
+                           glm::normalize(glm::vec3(transform[1])),
+                           glm::normalize(glm::vec3(transform[2])));
+  return glm::normalize(glm::quat_cast(rotation));
+}
+
+// Shortest rotation between two unit vectors
+glm::quat rotationBetween(const glm::vec3& from, const glm::vec3& to) {
+  const float cosAngle = glm::dot(from, to);
+  if (cosAngle < -1.0f + kEpsilon) {
+    // opposite vectors, half a turn around any perpendicular axis
+    glm::vec3 axis = glm::cross(glm::vec3(1.0f, 0.0f, 0.0f), from);
+    if (glm::dot(axis, axis) < kEpsilon) axis = glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), from);
+    return glm::angleAxis(glm::pi<float>(), glm::normalize(axis));
+  }
+  const glm::vec3 axis = glm::cross(from, to);
+  return glm::normalize(glm::quat(1.0f + cosAngle, axis.x, axis.y, axis.z));
+}
+
+// points[k] is the origin of bone k, which it rotates around, and the last point is the joint of
+// the last bone
+void gatherJoints(const Frame& frame, std::span<const int> bones, std::span<glm::vec3> points) {
+  for (size_t k = 0; k < bones.size(); ++k) points[k] = glm::vec3(frame.globals[bones[k]][3]);
+  const int last = bones.back();
+  points[bones.size()] = glm::vec3(frame.globals[last] * frame.inverseBinds[last] *
+                                   glm::vec4(frame.joints[last], 1.0f));
+}
+
+// Writes the local rotations moving the joints of the chain from before to after. Each bone is
+// rotated in model space so that its segment, already carried by the rotation of its parent,
+// points to its new joint.
+void applyJoints(const Frame& frame, std::span<const int> bones, std::span<const glm::vec3> before,
+                 std::span<const glm::vec3> after) {
+  const int parent = frame.parents[bones[0]];
+  glm::quat parentRotation =
+      parent < 0 ? glm::quat(1.0f, 0.0f, 0.0f, 0.0f) : rotationOf(frame.globals[parent]);
+  // rotation added to the previous bone, in model space
+  glm::quat delta(1.0f, 0.0f, 0.0f, 0.0f);
+  for (size_t k = 0; k < bones.size(); ++k) {
+    const glm::vec3 current = delta * direction(before[k], before[k + 1]);
+    const glm::vec3 wanted = direction(after[k], after[k + 1]);
+    if (glm::dot(current, current) > kEpsilon && glm::dot(wanted, wanted) > kEpsilon) {
+      delta = rotationBetween(current, wanted) * delta;
+    }
+    const glm::quat rotation = delta * rotationOf(frame.globals[bones[k]]);
+    frame.pose.rotations[bones[k]] = glm::normalize(glm::inverse(parentRotation) * rotation);
+    parentRotation = rotation;
+  }
+}
+
+bool solve(const Frame& frame, const TwoBoneChain& chain) {
+  const std::array<int, 2> bones{chain.upper, chain.lower};
+  if (!validChain(frame, bones)) return false;
+
+  std::array<glm::vec3, 3> before;
+  gatherJoints(frame, bones, before);
+  const glm::vec3 root = before[0];
+  const float upper = glm::length(before[1] - root);
+  const float lower = glm::length(before[2] - before[1]);
+  const float distance = glm::length(chain.target - root);
+  if (upper < kEpsilon || lower < kEpsilon || distance < kEpsilon) return false;
+
+  const glm::vec3 axis = (chain.target - root) / distance;
+  const float reach = std::clamp(distance, std::abs(upper - lower), upper + lower);
+
+  // the middle joint bends towards the pole, or keeps its current side when the pole is on the axis
+  auto perpendicular = [&](const glm::vec3& v) { return v - glm::dot(v, axis) * axis; };
+  glm::vec3 bend = perpendicular(chain.pole - root);
+  if (glm::dot(bend, bend) < kEpsilon) bend = perpendicular(before[1] - root);
+  if (glm::dot(bend, bend) < kEpsilon) bend = perpendicular(glm::vec3(1.0f, 0.0f, 0.0f));
+  if (glm::dot(bend, bend) < kEpsilon) bend = perpendicular(glm::vec3(0.0f, 1.0f, 0.0f));
+  bend = glm::normalize(bend);
+
+  // law of cosines for the angle at the root
+  const float cosAngle =
+      std::clamp((upper * upper + reach * reach - lower * lower) / (2.0f * upper * reach), -1.0f,
+                 1.0f);
+  const float sinAngle = std::sqrt(1.0f - cosAngle * cosAngle);
+
+  const std::array<glm::vec3, 3> after{root, root + upper * (cosAngle * axis + sinAngle * bend),
+                                       root + reach * axis};
+  applyJoints(frame, bones, before, after);
+  return std::abs(reach - distance) <= 1e-4f * (upper + lower);
+}
+
+bool solve(const Frame& frame, const IkChain& chain, const IkSettings& settings) {
+  if (!validChain(frame, chain.bones)) return false;
+
+  const size_t count = chain.bones.size();
+  std::array<glm::vec3, IkChain::kMaxBones + 1> before;
+  std::array<float, IkChain::kMaxBones> lengths;
+  gatherJoints(frame, chain.bones, before);
+  float total = 0.0f;
+  for (size_t k = 0; k < count; ++k) {
+    lengths[k] = glm::length(before[k + 1] - before[k]);
+    total += lengths[k];
+  }
+
+  std::array<glm::vec3, IkChain::kMaxBones + 1> points = before;
+  const glm::vec3 root = points[0];
+  bool reached = false;
+  if (glm::length(chain.target - root) >= total) {
+    // out of reach, stretch the chain towards the target
+    const glm::vec3 axis = direction(root, chain.target);
+    for (size_t k = 0; k < count; ++k) points[k + 1] = points[k] + lengths[k] * axis;
+    reached = glm::length(points[count] - chain.target) <= settings.tolerance;
+  } else {
+    reached = glm::length(points[count] - chain.target) <= settings.tolerance;
+    for (int iteration = 0; iteration < settings.iterations && !reached; ++iteration) {
+      // backward pass from the target, then forward pass from the fixed root
+      points[count] = chain.target;
+      for (size_t k = count; k-- > 0;) {
+        points[k] = points[k + 1] + lengths[k] * direction(points[k + 1], points[k]);
+      }
+      points[0] = root;
+      for (size_t k = 0; k < count; ++k) {
+        points[k + 1] = points[k] + lengths[k] * direction(points[k], points[k + 1]);
+      }
+      reached = glm::length(points[count] - chain.target) <= settings.tolerance;
+    }
+  }
+
+  applyJoints(frame, chain.bones, std::span(before).first(count + 1),
+              std::span(points).first(count + 1));
+  return reached;
+}
+
+// Chains are independent, small batches are enough to balance the threads
+constexpr size_t kGrain = 8;
+
+}  // namespace
+
+bool solveTwoBone(Skeleton& skeleton, const TwoBoneChain& chain) {
+  return solveTwoBone(skeleton, std::span(&chain, 1)) == 1;
+}
+
+size_t solveTwoBone(Skeleton& skeleton, std::span<const TwoBoneChain> chains) {
+  const Frame frame = snapshot(skeleton);
+  size_t solved = 0;
+  for (const auto& chain : chains) solved += solve(frame, chain);
+  return solved;
+}
+
+size_t solveTwoBone(Skeleton& skeleton, std::span<const TwoBoneChain> chains,
+                    core::ThreadPool& pool) {
+  const Frame frame = snapshot(skeleton);
+  std::atomic<size_t> solved = 0;
+  pool.parallelFor(chains.size(), kGrain, [&](size_t begin, size_t end) {
+    size_t local = 0;
+    for (size_t i = begin; i < end; ++i) local += solve(frame, chains[i]);
+    solved += local;
+  });
+  return solved;
+}
+
+bool solveFabrik(Skeleton& skeleton, const IkChain& chain, const IkSettings& settings) {
+  return solveFabrik(skeleton, std::span(&chain, 1), settings) == 1;
+}
+
+size_t solveFabrik(Skeleton& skeleton, std::span<const IkChain> chains,
+                   const IkSettings& settings) {
+  const Frame frame = snapshot(skeleton);
+  size_t solved = 0;
+  for (const auto& chain : chains) solved += solve(frame, chain, settings);
+  return solved;
+}
+
+size_t solveFabrik(Skeleton& skeleton, std::span<const IkChain> chains, core::ThreadPool& pool,
+                   const IkSettings& settings) {
+  const Frame frame = snapshot(skeleton);
+  std::atomic<size_t> solved = 0;
+  pool.parallelFor(chains.size(), kGrain, [&](size_t begin, size_t end) {
+    size_t local = 0;
+    for (size_t i = begin; i < end; ++i) local += solve(frame, chains[i], settings);
+    solved += local;
+  });
+  return solved;
+}
+
+}  // namespace gk::animation
@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Animation/Pose.hpp"
+
+#include <algorithm>
+#include <glm/gtc/quaternion.hpp>
+
+namespace gk::animation {
+
+namespace {
+
+float boneWeight(float weight, std::span<const float> mask, size_t bone) {
+  return mask.empty() ? weight : weight * mask[bone];
+}
+
+// Normalised linear interpolation along the shortest path
+glm::quat nlerp(const glm::quat& a, glm::quat b, float weight) {
+  if (glm::dot(a, b) < 0.0f) {
+    b = -b;
+  }
+  return glm::normalize(a * (1.0f - weight) + b * weight);
+}
+
+}  // namespace
+
+Pose::Pose(size_t nbBones) { resize(nbBones); }
+
+void Pose::resize(size_t nbBones) {
+  translations.resize(nbBones, glm::vec3(0.0f));
+  rotations.resize(nbBones, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+  scales.resize(nbBones, glm::vec3(1.0f));
+}
+
+size_t Pose::size() const noexcept { return rotations.size(); }
+
+void blend(const Pose& a, const Pose& b, float weight, Pose& out, std::span<const float> mask) {
+  const size_t bones = std::min(a.size(), b.size());
+  if (out.size() != bones) out.resize(bones);
+
+  for (size_t i = 0; i < bones; ++i) {
+    const float w = boneWeight(weight, mask, i);
+    out.translations[i] = glm::mix(a.translations[i], b.translations[i], w);
+    out.scales[i] = glm::mix(a.scales[i], b.scales[i], w);
+  }
+  for (size_t i = 0; i < bones; ++i) {
+    out.rotations[i] = nlerp(a.rotations[i], b.rotations[i], boneWeight(weight, mask, i));
+  }
+}
+
+void addAdditive(const Pose& base, const Pose& delta, float weight, Pose& out,
+                 std::span<const float> mask) {
+  const size_t bones = std::min(base.size(), delta.size());
+  if (out.size() != bones) out.resize(bones);
+
+  const glm::quat identity(1.0f, 0.0f, 0.0f, 0.0f);
+  for (size_t i = 0; i < bones; ++i) {
+    const float w = boneWeight(weight, mask, i);
+    out.translations[i] = base.translations[i] + delta.translations[i] * w;
+    out.scales[i] = base.scales[i] * glm::mix(glm::vec3(1.0f), delta.scales[i], w);
+  }
+  for (size_t i = 0; i < bones; ++i) {
+    const float w = boneWeight(weight, mask, i);
+    out.rotations[i] = glm::normalize(base.rotations[i] * nlerp(identity, delta.rotations[i], w));
+  }
+}
+
+void makeAdditive(const Pose& pose, const Pose& reference, Pose& out) {
+  const size_t bones = std::min(pose.size(), reference.size());
+  if (out.size() != bones) out.resize(bones);
+
+  for (size_t i = 0; i < bones; ++i) {
+    out.translations[i] = pose.translations[i] - reference.translations[i];
+    out.scales[i] = pose.scales[i] / reference.scales[i];
+    out.rotations[i] = glm::inverse(reference.rotations[i]) * pose.rotations[i];
+  }
+}
+
+}  // namespace gk::animation
@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Animation/Retarget.hpp"
+
+#include <stdexcept>
+#include <unordered_map>
+
+namespace gk::animation {
+
+RetargetMap::RetargetMap(const Skeleton& source, const Skeleton& target,
+                         std::span<const int> sourceBones, float translationScale)
+    : m_sourceBind(source.bindPose()),
+      m_sources(sourceBones.begin(), sourceBones.end()),
+      m_targetBind(target.bindPose()) {
+  const size_t count = target.size();
+  if (sourceBones.size() != count) {
+    throw std::invalid_argument("Retarget map does not match the target bones");
+  }
+  const auto targetParents = target.parents();
+
+  m_rotationOffsets.resize(count, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+  m_scaleRatios.resize(count, glm::vec3(1.0f));
+  m_sourceTranslations.resize(count, glm::vec3(0.0f));
+  m_translationWeights.resize(count, 0.0f);
+  for (size_t t = 0; t < count; ++t) {
+    const int s = m_sources[t];
+    if (s < 0) continue;
+    if (size_t(s) >= m_sourceBind.size()) {
+      throw std::out_of_range("Index out of range");
+    }
+    m_rotationOffsets[t] = m_targetBind.rotations[t] * glm::inverse(m_sourceBind.rotations[s]);
+    m_scaleRatios[t] = m_targetBind.scales[t] / m_sourceBind.scales[s];
+    m_sourceTranslations[t] = m_sourceBind.translations[s];
+    m_translationWeights[t] = targetParents[t] < 0 ? translationScale : 0.0f;
+  }
+}
+
+size_t RetargetMap::sourceSize() const noexcept { return m_sourceBind.size(); }
+
+size_t RetargetMap::targetSize() const noexcept { return m_sources.size(); }
+
+const Pose& RetargetMap::sourceBindPose() const noexcept { return m_sourceBind; }
+
+void RetargetMap::apply(const Pose& source, Pose& out) const {
+  const size_t count = m_sources.size();
+  if (out.size() != count) out.resize(count);
+  for (size_t t = 0; t < count; ++t) {
+    const int s = m_sources[t];
+    if (s < 0) {
+      out.translations[t] = m_targetBind.translations[t];
+      out.rotations[t] = m_targetBind.rotations[t];
+      out.scales[t] = m_targetBind.scales[t];
+      continue;
+    }
+    out.translations[t] =
+        m_targetBind.translations[t] +
+        (source.translations[s] - m_sourceTranslations[t]) * m_translationWeights[t];
+    out.rotations[t] = glm::normalize(m_rotationOffsets[t] * source.rotations[s]);
+    out.scales[t] = source.scales[s] * m_scaleRatios[t];
+  }
+}
+
+std::vector<int> matchBones(std::span<const std::string> sourceNames,
+                            std::span<const std::string> targetNames) {
+  std::unordered_map<std::string, int> sources;
+  for (size_t s = 0; s < sourceNames.size(); ++s) sources.emplace(sourceNames[s], int(s));
+  std::vector<int> map(targetNames.size(), -1);
+  for (size_t t = 0; t < targetNames.size(); ++t) {
+    auto it = sources.find(targetNames[t]);
+    if (it != sources.end()) map[t] = it->second;
+  }
+  return map;
+}
+
+}  // namespace gk::animation
@@ -6,44 +6,165 @@
 
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/fwd.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <stdexcept>
 
 namespace gk::animation {
-Skeleton::Skeleton(const glm::mat4& tr, glm::vec3 joint) {
-  m_bones.push_back({tr, joint, 0, -1, {}});
+Skeleton::Skeleton(const glm::vec3& joint) {
+  m_parents.push_back(-1);
+  m_joints.push_back(joint);
+  m_pivots.push_back(joint);
+  m_bindPose.resize(1);
+  m_bindPose.translations[0] = joint;
+  m_inverseBinds.push_back(glm::translate(glm::mat4(1.0f), -joint));
+  m_pose = m_bindPose;
 }
 
-int Skeleton::addBone(const glm::mat4& tr, glm::vec3 joint, int parent) {
-  if (m_bones[parent].numChild >= 4) {
+Skeleton::Skeleton(std::span<const int> parents, const Pose& bindPose,
+                   std::span<const glm::mat4> inverseBindMatrices)
+    : m_parents(parents.begin(), parents.end()), m_bindPose(bindPose), m_pose(bindPose) {
+  const size_t count = m_parents.size();
+  if (bindPose.size() != count || bindPose.translations.size() != count ||
+      bindPose.scales.size() != count) {
+    throw std::invalid_argument("Bind pose does not match the bones");
+  }
+  if (!inverseBindMatrices.empty() && inverseBindMatrices.size() != count) {
+    throw std::invalid_argument("Inverse bind matrices do not match the bones");
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (m_parents[i] >= int(i) || m_parents[i] < -1) {
+      throw std::invalid_argument("Parents must come before their children");
+    }
+  }
+
+  // the skinning matrices of the bind pose are its globals times their inverse
+  update();
+  if (inverseBindMatrices.empty()) {
+    m_inverseBinds.resize(count);
+    for (size_t i = 0; i < count; ++i) m_inverseBinds[i] = glm::inverse(m_globals[i]);
+  } else {
+    m_inverseBinds.assign(inverseBindMatrices.begin(), inverseBindMatrices.end());
+  }
+
+  m_pivots.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    m_pivots[i] = glm::vec3(glm::inverse(m_inverseBinds[i])[3]);
+  }
+  m_joints = m_pivots;
+  // walking backwards leaves the first child as the joint
+  for (size_t i = count; i-- > 0;) {
+    if (m_parents[i] >= 0) m_joints[m_parents[i]] = m_pivots[i];
+  }
+  m_needUpdate = true;
+}
+
+int Skeleton::addBone(const glm::vec3& joint, int parent) {
+  if (parent < 0 || parent >= size()) {
     return -1;
   }
-  m_bones.push_back({tr, joint, 0, parent, {}});
-  m_bones[parent].children[m_bones[parent].numChild++] = m_bones.size() - 1;
-  return m_bones.size() - 1;
+  const glm::vec3 pivot = m_joints[parent];
+  m_parents.push_back(parent);
+  m_joints.push_back(joint);
+  m_pivots.push_back(pivot);
+  // the bind frame of the bone is the frame of its parent moved to the pivot
+  const glm::vec3 translation = glm::vec3(m_inverseBinds[parent] * glm::vec4(pivot, 1.0f));
+  m_bindPose.resize(m_parents.size());
+  m_bindPose.translations.back() = translation;
+  m_inverseBinds.push_back(glm::translate(glm::mat4(1.0f), -translation) * m_inverseBinds[parent]);
+  m_pose.resize(m_parents.size());
+  m_pose.translations.back() = m_bindPose.translations.back();
+  m_needUpdate = true;
+  return size() - 1;
 }
 
-Bone& Skeleton::operator[](int index) { return m_bones[index]; }
+void Skeleton::moveBone(int index, float angle, const glm::vec3& axis) {
+  if (m_parents[index] == -1) return;
+  setRotation(index, m_pose.rotations[index] * glm::angleAxis(glm::radians(angle), axis));
+}
+
+void Skeleton::setTranslation(int index, const glm::vec3& translation) {
+  m_pose.translations[index] = translation;
+  m_needUpdate = true;
+}
+
+void Skeleton::setRotation(int index, const glm::quat& rotation) {
+  // renormalise so that accumulated rotations do not drift
+  m_pose.rotations[index] = glm::normalize(rotation);
+  m_needUpdate = true;
+}
+
+void Skeleton::setScale(int index, const glm::vec3& scale) {
+  m_pose.scales[index] = scale;
+  m_needUpdate = true;
+}
 
-int Skeleton::size() const { return m_bones.size(); }
+std::span<const int> Skeleton::parents() const noexcept { return m_parents; }
 
-void Skeleton::propagateTransform(const glm::mat4& tr, Bone& bone) {
-  bone.joint = glm::vec3(tr * glm::vec4(bone.joint, 1.0f));
-  bone.tr = tr * bone.tr;
-  for (int i = 0; i < bone.numChild; i++) {
-    propagateTransform(tr, m_bones[bone.children[i]]);
+const Pose& Skeleton::bindPose() const noexcept { return m_bindPose; }
+
+std::span<const glm::mat4> Skeleton::inverseBindMatrices() const noexcept {
+  return m_inverseBinds;
+}
+
+std::span<const glm::vec3> Skeleton::bindJoints() const noexcept { return m_joints; }
+
+const Pose& Skeleton::pose() const noexcept { return m_pose; }
+
+Pose& Skeleton::editPose() {
+  m_needUpdate = true;
+  return m_pose;
+}
+
+void Skeleton::resetPose() {
+  m_pose = m_bindPose;
+  m_needUpdate = true;
+}
+
+std::span<const glm::mat4> Skeleton::globalTransforms() {
+  if (m_needUpdate) update();
+  return m_globals;
+}
+
+std::span<const glm::mat4> Skeleton::skinningMatrices() {
+  if (m_needUpdate) update();
+  return m_skinning;
+}
+
+std::span<const DualQuat> Skeleton::skinningDualQuats() {
+  if (m_needUpdate) update();
+  if (m_dualQuatsNeedUpdate) {
+    m_skinningDualQuats.resize(m_skinning.size());
+    toDualQuats(m_skinning, m_skinningDualQuats);
+    m_dualQuatsNeedUpdate = false;
   }
+  return m_skinningDualQuats;
 }
 
-void Skeleton::moveBone(int index, float angle, const glm::vec3& axis) {
-  Bone& bone = m_bones[index];
-  if (bone.parent == -1) return;
+glm::vec3 Skeleton::joint(int index) {
+  if (m_needUpdate) update();
+  return glm::vec3(m_skinning[index] * glm::vec4(m_joints[index], 1.0f));
+}
 
-  glm::vec3 center = m_bones[bone.parent].joint;
+int Skeleton::size() const { return m_parents.size(); }
 
-  glm::mat4 translationToOrigin = glm::translate(glm::mat4(1.0f), -center);
-  glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(angle), axis);
-  glm::mat4 translationBack = glm::translate(glm::mat4(1.0f), center);
+void Skeleton::update() {
+  const size_t count = m_parents.size();
+  m_globals.resize(count);
+  m_skinning.resize(count);
 
-  propagateTransform(translationBack * rotation * translationToOrigin, bone);
+  // parents come first, their global transform is always ready when a child reads it
+  for (size_t i = 0; i < count; ++i) {
+    glm::mat4 local = glm::translate(glm::mat4(1.0f), m_pose.translations[i]) *
+                      glm::mat4_cast(m_pose.rotations[i]) *
+                      glm::scale(glm::mat4(1.0f), m_pose.scales[i]);
+    m_globals[i] = m_parents[i] < 0 ? local : m_globals[m_parents[i]] * local;
+  }
+  // not known yet while an imported skeleton computes them from its bind pose
+  if (m_inverseBinds.size() == count) {
+    for (size_t i = 0; i < count; ++i) m_skinning[i] = m_globals[i] * m_inverseBinds[i];
+  }
+  m_needUpdate = false;
+  m_dualQuatsNeedUpdate = true;
 }
 
 }  // namespace gk::animation
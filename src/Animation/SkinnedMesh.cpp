@@ -0,0 +1,83 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Animation/SkinnedMesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace gk::animation {
+
+template <typename Weight>
+std::expected<PackedSkinnedMesh<Weight>, PackingReport> pack(const SkinnedMesh& mesh) {
+  constexpr float maxWeight = float(std::numeric_limits<Weight>::max());
+  PackedSkinnedMesh<Weight> packed;
+  PackingReport report;
+  packed.vertices.resize(mesh.vertices.size());
+  packed.indices = mesh.indices;
+
+  for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+    const auto& in = mesh.vertices[v];
+    auto& out = packed.vertices[v];
+    out.position = in.position;
+    out.normal = in.normal;
+    out.uv = in.uv;
+    out.boneIdx = {};
+    out.boneWeights = {};
+
+    float total = 0.0f;
+    bool valid = true;
+    const int count = std::clamp(in.boneCount, 0, 4);
+    for (int i = 0; i < count; ++i) {
+      if (in.boneWeights[i] <= 0.0f) continue;
+      if (in.boneIdx[i] < 0 || in.boneIdx[i] >= int(PackedSkinnedMesh<Weight>::kMaxBones)) {
+        valid = false;
+        continue;
+      }
+      total += in.boneWeights[i];
+    }
+    if (!valid) {
+      report.invalidBones.push_back(v);
+      continue;
+    }
+    if (total <= 0.0f) {
+      report.noWeights.push_back(v);
+      continue;
+    }
+
+    // round every weight, then give the rounding error to the largest one so the sum is exact
+    int sum = 0;
+    int largest = 0;
+    for (int i = 0; i < count; ++i) {
+      if (in.boneWeights[i] <= 0.0f) continue;
+      const int q = int(std::lround(in.boneWeights[i] / total * maxWeight));
+      out.boneIdx[i] = uint8_t(in.boneIdx[i]);
+      out.boneWeights[i] = Weight(q);
+      sum += q;
+      if (out.boneWeights[i] > out.boneWeights[largest]) largest = i;
+    }
+    out.boneWeights[largest] = Weight(int(out.boneWeights[largest]) + int(maxWeight) - sum);
+  }
+
+  if (!report.invalidBones.empty() || !report.noWeights.empty()) {
+    return std::unexpected{std::move(report)};
+  }
+  return packed;
+}
+
+template std::expected<SkinnedMesh8, PackingReport> pack<uint8_t>(const SkinnedMesh&);
+template std::expected<SkinnedMesh16, PackingReport> pack<uint16_t>(const SkinnedMesh&);
+
+geometry::AABB skinnedBounds(const geometry::AABB& bindBounds,
+                             std::span<const glm::mat4> palette) noexcept {
+  if (palette.empty() || bindBounds.empty()) return bindBounds;
+  geometry::AABB box;
+  for (const auto& matrix : palette) {
+    box.expand(bindBounds.transformed(matrix));
+  }
+  return box;
+}
+
+}  // namespace gk::animation
@@ -0,0 +1,92 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Core/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace gk::core {
+
+namespace {
+thread_local bool t_insideTask = false;
+}
+
+ThreadPool::ThreadPool(unsigned int threads) {
+  const unsigned int workers = std::max(threads, 1u) - 1;
+  m_workers.reserve(workers);
+  for (unsigned int i = 0; i < workers; ++i) {
+    m_workers.emplace_back([this](std::stop_token stop) { workerLoop(stop); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  for (auto& worker : m_workers) {
+    worker.request_stop();
+  }
+  m_wake.notify_all();
+  // join before the synchronisation primitives are destroyed
+  m_workers.clear();
+}
+
+unsigned int ThreadPool::size() const noexcept { return m_workers.size() + 1; }
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const Task& task) {
+  if (count == 0) return;
+  grain = std::max<size_t>(grain, 1);
+  if (m_workers.empty() || count <= grain || t_insideTask) {
+    task(0, count);
+    return;
+  }
+
+  std::lock_guard submit(m_submitMutex);
+  {
+    std::lock_guard lock(m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_grain = grain;
+    m_next = 0;
+    m_activeWorkers = m_workers.size();
+    ++m_generation;
+  }
+  m_wake.notify_all();
+
+  t_insideTask = true;
+  runChunks();
+  t_insideTask = false;
+
+  std::unique_lock lock(m_mutex);
+  m_done.wait(lock, [this] { return m_activeWorkers == 0; });
+  m_task = nullptr;
+}
+
+void ThreadPool::runChunks() {
+  for (;;) {
+    const size_t begin = m_next.fetch_add(m_grain, std::memory_order_relaxed);
+    if (begin >= m_count) break;
+    (*m_task)(begin, std::min(begin + m_grain, m_count));
+  }
+}
+
+void ThreadPool::workerLoop(std::stop_token stop) {
+  t_insideTask = true;
+  std::uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock lock(m_mutex);
+      if (!m_wake.wait(lock, stop, [&] { return m_generation != seen; })) {
+        return;
+      }
+      seen = m_generation;
+    }
+    runChunks();
+    {
+      std::lock_guard lock(m_mutex);
+      if (--m_activeWorkers == 0) {
+        m_done.notify_one();
+      }
+    }
+  }
+}
+
+}  // namespace gk::core
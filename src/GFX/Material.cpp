@@ -47,5 +47,14 @@ Material createPhongMaterialAnimated(io::RessourceManager& ressourceManager) {
   return createMaterial(ressourceManager, "shaders/OpenGL/meshLBS.vert", "shaders/OpenGL/phong.frag");
 }
 
+Material createPhongMaterialAnimatedPacked(io::RessourceManager& ressourceManager) {
+  return createMaterial(ressourceManager, "shaders/OpenGL/meshLBSPacked.vert",
+                        "shaders/OpenGL/phong.frag");
+}
+
+Material createPhongMaterialDQS(io::RessourceManager& ressourceManager) {
+  return createMaterial(ressourceManager, "shaders/OpenGL/meshDQS.vert", "shaders/OpenGL/phong.frag");
+}
+
 
 }  // namespace gk::gfx
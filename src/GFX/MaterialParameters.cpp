@@ -39,10 +39,15 @@ std::span<const std::pair<std::string, glm::mat3>> MockParameters::mat3Parameter
   return {};
 };
 
-std::vector<std::pair<std::string, glm::mat4>> MockParameters::mat4Parameters() const noexcept {
+std::span<const std::pair<std::string, glm::mat4>> MockParameters::mat4Parameters()
+    const noexcept {
   return {};
 };
 
+std::span<const std::byte> MockParameters::bonePalette() const noexcept { return {}; }
+
+std::span<const glm::mat4> MockParameters::skinningMatrices() const noexcept { return {}; }
+
 PhongMaterialParams::PhongMaterialParams() {
   // copper by default
   m_vecParams[0] = {"material.ambient", glm::vec3(0.19125, 0.0735, 0.0225)};
@@ -93,11 +98,15 @@ std::span<const std::pair<std::string, glm::mat3>> PhongMaterialParams::mat3Para
   return {};
 };
 
-std::vector<std::pair<std::string, glm::mat4>> PhongMaterialParams::mat4Parameters()
+std::span<const std::pair<std::string, glm::mat4>> PhongMaterialParams::mat4Parameters()
     const noexcept {
   return {};
 };
 
+std::span<const std::byte> PhongMaterialParams::bonePalette() const noexcept { return {}; }
+
+std::span<const glm::mat4> PhongMaterialParams::skinningMatrices() const noexcept { return {}; }
+
 void PhongMaterialParams::setParameter(const std::string& key, const glm::vec3 value) noexcept {
   if (key == "material.ambient") {
     m_vecParams[0].second = value;
@@ -114,12 +123,10 @@ void PhongMaterialParams::setParameter(const std::string& key, const glm::float3
 }
 
 PhongMaterialParamsAnimated::PhongMaterialParamsAnimated(
-    std::unique_ptr<animation::Skeleton>&& skeleton) {
+    std::unique_ptr<animation::Skeleton>&& skeleton, SkinningMode mode)
+    : m_mode(mode) {
   m_skel = std::move(skeleton);
   m_numBones = std::pair{"num_bones", m_skel->size()};
-  for (int i = 0; i < m_skel->size(); i++) {
-    m_bonesParams.push_back(std::pair{"bones[" + std::to_string(i) + "]", (*m_skel)[i].tr});
-  }
 }
 
 std::span<const std::pair<std::string, glm::int32>> PhongMaterialParamsAnimated::intParameters()
@@ -129,13 +136,19 @@ std::span<const std::pair<std::string, glm::int32>> PhongMaterialParamsAnimated:
 
 animation::Skeleton& PhongMaterialParamsAnimated::skeleton() { return *m_skel; }
 
-std::vector<std::pair<std::string, glm::mat4>> PhongMaterialParamsAnimated::mat4Parameters()
-    const noexcept {
-  std::vector<std::pair<std::string, glm::mat4>> params = m_bonesParams;
-  for (int i = 0; i < m_skel->size(); i++) {
-    params[i].second = (*m_skel)[i].tr;
+SkinningMode PhongMaterialParamsAnimated::skinningMode() const noexcept { return m_mode; }
+
+std::span<const std::byte> PhongMaterialParamsAnimated::bonePalette() const noexcept {
+  // the layouts match the std430 blocks of the skinning shaders: column major mat4, and the real
+  // then dual part of each dual quaternion stored as (x, y, z, w)
+  if (m_mode == SkinningMode::eDualQuaternion) {
+    return std::as_bytes(m_skel->skinningDualQuats());
   }
-  return params;
+  return std::as_bytes(m_skel->skinningMatrices());
+}
+
+std::span<const glm::mat4> PhongMaterialParamsAnimated::skinningMatrices() const noexcept {
+  return m_skel->skinningMatrices();
 }
 
 MetallicRoughnessMaterialParams::MetallicRoughnessMaterialParams(const glm::vec4& baseColorFactor,
@@ -0,0 +1,95 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+#include "GFX/OpenGL/GLRingBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace gk::gfx::gl {
+
+namespace {
+
+constexpr GLbitfield kMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+void waitFence(GLsync& fence) {
+  if (!fence) return;
+  // one second per wait, the fence only blocks when the GPU is frames behind
+  constexpr GLuint64 timeout = 1'000'000'000;
+  while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout) == GL_TIMEOUT_EXPIRED) {
+  }
+  glDeleteSync(fence);
+  fence = nullptr;
+}
+
+}  // namespace
+
+RingBuffer::RingBuffer(GLenum target, size_t sectionSize, size_t frames)
+    : m_target(target), m_fences(std::max<size_t>(frames, 1), nullptr) {
+  GLint alignment = 1;
+  if (target == GL_SHADER_STORAGE_BUFFER) {
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  } else if (target == GL_UNIFORM_BUFFER) {
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  }
+  m_alignment = std::max(alignment, 1);
+  allocate(sectionSize);
+}
+
+RingBuffer::~RingBuffer() {
+  for (auto& fence : m_fences) {
+    if (fence) glDeleteSync(fence);
+  }
+  release();
+}
+
+RingBuffer::Range RingBuffer::write(std::span<const std::byte> data) {
+  const size_t offset = (m_head + m_alignment - 1) / m_alignment * m_alignment;
+  if (offset + data.size() > m_sectionSize) {
+    // Draws already issued keep the old storage alive, the new buffer needs no synchronisation.
+    // Fences of the old buffer are dropped with it.
+    for (auto& fence : m_fences) {
+      if (fence) glDeleteSync(fence);
+      fence = nullptr;
+    }
+    release();
+    allocate(std::max(2 * m_sectionSize, data.size()));
+    m_head = 0;
+    return write(data);
+  }
+  std::memcpy(m_data + m_frame * m_sectionSize + offset, data.data(), data.size());
+  m_head = offset + data.size();
+  return {GLintptr(m_frame * m_sectionSize + offset), GLsizeiptr(data.size())};
+}
+
+void RingBuffer::bindRange(GLuint index, const Range& range) const noexcept {
+  glBindBufferRange(m_target, index, m_id, range.offset, range.size);
+}
+
+void RingBuffer::nextFrame() {
+  m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  m_frame = (m_frame + 1) % m_fences.size();
+  m_head = 0;
+  waitFence(m_fences[m_frame]);
+}
+
+void RingBuffer::allocate(size_t sectionSize) {
+  // sections start on a bindable offset
+  m_sectionSize = (sectionSize + m_alignment - 1) / m_alignment * m_alignment;
+  const GLsizeiptr size = GLsizeiptr(m_sectionSize * m_fences.size());
+  glGenBuffers(1, &m_id);
+  glBindBuffer(m_target, m_id);
+  glBufferStorage(m_target, size, nullptr, kMapFlags);
+  m_data = static_cast<std::byte*>(glMapBufferRange(m_target, 0, size, kMapFlags));
+}
+
+void RingBuffer::release() noexcept {
+  if (!m_id) return;
+  glBindBuffer(m_target, m_id);
+  glUnmapBuffer(m_target);
+  glDeleteBuffers(1, &m_id);
+  m_id = 0;
+  m_data = nullptr;
+}
+
+}  // namespace gk::gfx::gl
@@ -4,6 +4,7 @@
 
 #include "GFX/OpenGL/GLShaderProgram.hpp"
 
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <iostream>
 #include <span>
@@ -98,22 +99,58 @@ void ShaderProgram::updateAttributes() noexcept {
                                            .size = num,
                                            .type_enum = gl_type,
                                            .stride = 0,
-                                           .offset = (void*)offset,
+                                           .offset = nullptr,
                                            .location = location});
-    offset += size;
+  }
+
+  // vertex members are laid out in location order, whatever the order the resources are listed in
+  std::sort(m_attributes.begin(), m_attributes.end(),
+            [](const VertexAttribute& a, const VertexAttribute& b) { return a.location < b.location; });
+  for (auto& attrib : m_attributes) {
+    attrib.offset = (void*)offset;
+    offset += attrib.size * std::get<2>(componentsTypeSize(attrib.type_enum));
   }
   for (auto& attrib : m_attributes) {
     attrib.stride = offset;
   }
 }
-void ShaderProgram::enableVertexAttributes() const noexcept {
+
+void ShaderProgram::enableVertexAttributes(GLsizei stride) const noexcept {
   for (auto& attrib : m_attributes) {
-    glVertexAttribPointer(attrib.location, attrib.size, GL_FLOAT, GL_FALSE, attrib.stride,
-                          attrib.offset);
+    switch (attrib.type_enum) {
+      case GL_INT:
+      case GL_UNSIGNED_INT:
+        // integer attributes would be converted to floats by glVertexAttribPointer
+        glVertexAttribIPointer(attrib.location, attrib.size, attrib.type_enum, stride,
+                               attrib.offset);
+        break;
+      case GL_DOUBLE:
+        glVertexAttribLPointer(attrib.location, attrib.size, attrib.type_enum, stride,
+                               attrib.offset);
+        break;
+      default:
+        glVertexAttribPointer(attrib.location, attrib.size, attrib.type_enum, GL_FALSE, stride,
+                              attrib.offset);
+        break;
+    }
     glEnableVertexAttribArray(attrib.location);
   }
 }
 
+void ShaderProgram::enableVertexAttributes(std::span<const VertexFormat> formats,
+                                           GLsizei stride) const noexcept {
+  for (auto& format : formats) {
+    const auto offset = reinterpret_cast<const GLvoid*>(format.offset);
+    if (format.integer) {
+      glVertexAttribIPointer(format.location, format.size, format.type, stride, offset);
+    } else {
+      glVertexAttribPointer(format.location, format.size, format.type, format.normalized, stride,
+                            offset);
+    }
+    glEnableVertexAttribArray(format.location);
+  }
+}
+
 void ShaderProgram::link() noexcept {
   if (!m_linked) {
     glLinkProgram(m_id);
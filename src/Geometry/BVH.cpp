@@ -0,0 +1,189 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Geometry/BVH.hpp"
+
+#include <stdexcept>
+
+namespace gk::geometry {
+
+uint32_t DynamicBVH::allocate() {
+  if (m_free == kNull) {
+    m_nodes.emplace_back();
+    return uint32_t(m_nodes.size() - 1);
+  }
+  const uint32_t node = m_free;
+  m_free = m_nodes[node].parent;
+  m_nodes[node] = {};
+  return node;
+}
+
+void DynamicBVH::release(uint32_t node) noexcept {
+  m_nodes[node] = {};
+  m_nodes[node].parent = m_free;
+  m_free = node;
+}
+
+uint32_t DynamicBVH::findSibling(const AABB& box) const noexcept {
+  // Descends while pairing the box with a child is cheaper than pairing it with the node, the
+  // cost being the surface added to the tree (Goldsmith and Salmon)
+  uint32_t index = m_root;
+  while (!m_nodes[index].leaf()) {
+    const Node& node = m_nodes[index];
+    const float area = node.box.surfaceArea();
+    const float combined = merge(node.box, box).surfaceArea();
+    // a new parent here covers both, every ancestor of the children grows as much as this node
+    const float cost = 2.0f * combined;
+    const float inherited = 2.0f * (combined - area);
+
+    auto childCost = [&](uint32_t child) {
+      const AABB& childBox = m_nodes[child].box;
+      const float merged = merge(childBox, box).surfaceArea();
+      return m_nodes[child].leaf() ? merged + inherited
+                                   : merged - childBox.surfaceArea() + inherited;
+    };
+    const float leftCost = childCost(node.left);
+    const float rightCost = childCost(node.right);
+    if (cost < leftCost && cost < rightCost) break;
+    index = leftCost < rightCost ? node.left : node.right;
+  }
+  return index;
+}
+
+void DynamicBVH::refit(uint32_t node) noexcept {
+  while (node != kNull) {
+    Node& current = m_nodes[node];
+    const AABB box = merge(m_nodes[current.left].box, m_nodes[current.right].box);
+    if (box == current.box) return;
+    current.box = box;
+    rotate(node);
+    node = current.parent;
+  }
+}
+
+void DynamicBVH::rotate(uint32_t node) noexcept {
+  // Swaps a child with a grandchild under the other child when that shrinks the other child, the
+  // box of node itself does not change (Kopta et al., Catto). Keeps the tree from degenerating
+  // into a list when the boxes come in sorted order.
+  const Node& current = m_nodes[node];
+  const uint32_t left = current.left;
+  const uint32_t right = current.right;
+  uint32_t child = kNull;
+  uint32_t grandChild = kNull;
+  float bestGain = 0.0f;
+  auto consider = [&](uint32_t from, uint32_t uncle, uint32_t to, uint32_t kept) {
+    const float gain = m_nodes[uncle].box.surfaceArea() -
+                       merge(m_nodes[from].box, m_nodes[kept].box).surfaceArea();
+    if (gain > bestGain) {
+      bestGain = gain;
+      child = from;
+      grandChild = to;
+    }
+  };
+  if (!m_nodes[right].leaf()) {
+    consider(left, right, m_nodes[right].left, m_nodes[right].right);
+    consider(left, right, m_nodes[right].right, m_nodes[right].left);
+  }
+  if (!m_nodes[left].leaf()) {
+    consider(right, left, m_nodes[left].left, m_nodes[left].right);
+    consider(right, left, m_nodes[left].right, m_nodes[left].left);
+  }
+  if (child == kNull) return;
+
+  const uint32_t uncle = m_nodes[grandChild].parent;
+  Node& parent = m_nodes[node];
+  (parent.left == child ? parent.left : parent.right) = grandChild;
+  Node& other = m_nodes[uncle];
+  (other.left == grandChild ? other.left : other.right) = child;
+  m_nodes[grandChild].parent = node;
+  m_nodes[child].parent = uncle;
+  other.box = merge(m_nodes[other.left].box, m_nodes[other.right].box);
+}
+
+uint32_t DynamicBVH::insert(const AABB& box, uint32_t value) {
+  const uint32_t leaf = allocate();
+  m_nodes[leaf].box = box;
+  m_nodes[leaf].value = value;
+  ++m_leaves;
+  if (m_root == kNull) {
+    m_root = leaf;
+    return leaf;
+  }
+
+  const uint32_t sibling = findSibling(box);
+  const uint32_t parent = allocate();
+  const uint32_t grandParent = m_nodes[sibling].parent;
+  m_nodes[parent].parent = grandParent;
+  m_nodes[parent].left = sibling;
+  m_nodes[parent].right = leaf;
+  m_nodes[parent].box = merge(m_nodes[sibling].box, box);
+  m_nodes[sibling].parent = parent;
+  m_nodes[leaf].parent = parent;
+  rotate(parent);
+  if (grandParent == kNull) {
+    m_root = parent;
+  } else {
+    Node& node = m_nodes[grandParent];
+    (node.left == sibling ? node.left : node.right) = parent;
+    refit(grandParent);
+  }
+  return leaf;
+}
+
+void DynamicBVH::remove(uint32_t leaf) {
+  const uint32_t parent = leafNode(leaf).parent;
+  release(leaf);
+  --m_leaves;
+  if (parent == kNull) {
+    m_root = kNull;
+    return;
+  }
+
+  // the sibling takes the place of the parent
+  const uint32_t grandParent = m_nodes[parent].parent;
+  const uint32_t sibling =
+      m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+  release(parent);
+  m_nodes[sibling].parent = grandParent;
+  if (grandParent == kNull) {
+    m_root = sibling;
+  } else {
+    Node& node = m_nodes[grandParent];
+    (node.left == parent ? node.left : node.right) = sibling;
+    refit(grandParent);
+  }
+}
+
+void DynamicBVH::update(uint32_t leaf, const AABB& box) {
+  leafNode(leaf);
+  m_nodes[leaf].box = box;
+  refit(m_nodes[leaf].parent);
+}
+
+void DynamicBVH::clear() noexcept {
+  m_nodes.clear();
+  m_root = kNull;
+  m_free = kNull;
+  m_leaves = 0;
+}
+
+void DynamicBVH::reserve(size_t leaves) {
+  // a binary tree with n leaves has n - 1 inner nodes
+  m_nodes.reserve(2 * leaves);
+}
+
+size_t DynamicBVH::size() const noexcept { return m_leaves; }
+
+const AABB& DynamicBVH::bounds(uint32_t leaf) const { return leafNode(leaf).box; }
+
+uint32_t DynamicBVH::value(uint32_t leaf) const { return leafNode(leaf).value; }
+
+const DynamicBVH::Node& DynamicBVH::leafNode(uint32_t leaf) const {
+  if (leaf >= m_nodes.size() || !m_nodes[leaf].leaf() || m_nodes[leaf].value == kNull) {
+    throw std::out_of_range("Index out of range");
+  }
+  return m_nodes[leaf];
+}
+
+}  // namespace gk::geometry
@@ -0,0 +1,88 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Geometry/Bounds.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+namespace gk::geometry {
+
+bool AABB::empty() const noexcept { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+glm::vec3 AABB::center() const noexcept { return (min + max) * 0.5f; }
+
+glm::vec3 AABB::extents() const noexcept { return (max - min) * 0.5f; }
+
+float AABB::surfaceArea() const noexcept {
+  if (empty()) return 0.0f;
+  const glm::vec3 size = max - min;
+  return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool AABB::contains(const AABB& other) const noexcept {
+  if (other.empty()) return true;
+  return glm::all(glm::lessThanEqual(min, other.min)) &&
+         glm::all(glm::greaterThanEqual(max, other.max));
+}
+
+void AABB::expand(const glm::vec3& point) noexcept {
+  min = glm::min(min, point);
+  max = glm::max(max, point);
+}
+
+void AABB::expand(const AABB& other) noexcept {
+  min = glm::min(min, other.min);
+  max = glm::max(max, other.max);
+}
+
+AABB AABB::transformed(const glm::mat4& transform) const noexcept {
+  if (empty()) return {};
+  // Arvo: the extents along each axis are the absolute values of the rotated extents
+  const glm::vec3 center = glm::vec3(transform * glm::vec4(this->center(), 1.0f));
+  const glm::vec3 extents = this->extents();
+  glm::vec3 radius(0.0f);
+  for (int column = 0; column < 3; ++column) {
+    radius += glm::abs(glm::vec3(transform[column])) * extents[column];
+  }
+  return {center - radius, center + radius};
+}
+
+AABB merge(const AABB& a, const AABB& b) noexcept {
+  AABB box = a;
+  box.expand(b);
+  return box;
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection) noexcept {
+  // Gribb and Hartmann, the planes are sums and differences of the rows of the matrix
+  const glm::mat4 m = glm::transpose(viewProjection);
+  m_planes = {m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[3] + m[2], m[3] - m[2]};
+  for (auto& plane : m_planes) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+}
+
+bool Frustum::intersects(const AABB& box) const noexcept {
+  if (box.empty()) return false;
+  const glm::vec3 center = box.center();
+  const glm::vec3 extents = box.extents();
+  for (const auto& plane : m_planes) {
+    const glm::vec3 normal(plane);
+    // distance of the center against the projected radius of the box on the normal
+    const float radius = glm::dot(extents, glm::abs(normal));
+    if (glm::dot(normal, center) + plane.w < -radius) return false;
+  }
+  return true;
+}
+
+bool Frustum::intersects(const BoundingSphere& sphere) const noexcept {
+  if (sphere.radius < 0.0f) return false;
+  return std::ranges::all_of(m_planes, [&sphere](const glm::vec4& plane) {
+    return glm::dot(glm::vec3(plane), sphere.center) + plane.w >= -sphere.radius;
+  });
+}
+
+}  // namespace gk::geometry
@@ -4,42 +4,57 @@
 
 #include "Geometry/Curves.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <glm/ext/vector_float3.hpp>
 #include <glm/fwd.hpp>
+#include <span>
 #include <stdexcept>
 #include <vector>
 
+#include "Geometry/algorithm.hpp"
+
 void gk::geometry::SimpleCurve::registerPoint(glm::vec2 point) {
-  m_points.push_back(glm::vec3(point, 0.0));
-  updateIndices();
+  registerPoint(glm::vec3(point, 0.0));
 }
 
 void gk::geometry::SimpleCurve::registerPoint(glm::vec3 point) {
+  reserve(1);
   m_points.push_back(point);
-  updateIndices();
+  appendIndices(m_points.size() - 1);
 }
 
-void gk::geometry::SimpleCurve::registerPoints(std::vector<glm::vec2> points) {
+void gk::geometry::SimpleCurve::registerPoints(std::span<const glm::vec2> points) {
+  const size_t first = m_points.size();
+  reserve(points.size());
   for (auto point : points) {
     m_points.push_back(glm::vec3(point, 0.0));
   }
-  updateIndices();
+  appendIndices(first);
 }
-void gk::geometry::SimpleCurve::registerPoints(std::vector<glm::vec3> points) {
-  for (auto point : points) {
-    m_points.push_back(point);
+
+void gk::geometry::SimpleCurve::registerPoints(std::span<const glm::vec3> points) {
+  const size_t first = m_points.size();
+  reserve(points.size());
+  m_points.insert(m_points.end(), points.begin(), points.end());
+  appendIndices(first);
+}
+
+void gk::geometry::SimpleCurve::reserve(size_t count) {
+  const size_t size = m_points.size() + count;
+  if (size > m_points.capacity()) {
+    const size_t capacity = std::max(size, 2 * m_points.capacity());
+    m_points.reserve(capacity);
+    m_indices.reserve(2 * capacity);
   }
-  updateIndices();
 }
 
-inline void gk::geometry::SimpleCurve::updateIndices() {
-  m_indices.reserve(m_points.size() * 2);
-  for (size_t i = 0; i < m_points.size(); ++i) {
+void gk::geometry::SimpleCurve::appendIndices(size_t first) {
+  // one line per pair of consecutive points
+  for (size_t i = std::max<size_t>(first, 1); i < m_points.size(); ++i) {
+    m_indices.push_back(i - 1);
     m_indices.push_back(i);
-    if (i < m_points.size()) {
-      m_indices.push_back(i + 1);
-    }
   }
 }
 
@@ -54,4 +69,74 @@ const std::vector<unsigned>& gk::geometry::SimpleCurve::indices() { return m_ind
 
 const std::vector<glm::vec3>& gk::geometry::SimpleCurve::curve() { return m_points; }
 
-// TODO: PieceWiseBezier
+void gk::geometry::ArcLengthTable::build(std::span<const glm::vec3> points) {
+  m_lengths.resize(points.size());
+  if (points.empty()) return;
+  m_lengths[0] = 0.0f;
+  for (size_t i = 1; i < points.size(); ++i) {
+    m_lengths[i] = m_lengths[i - 1] + glm::distance(points[i - 1], points[i]);
+  }
+}
+
+void gk::geometry::ArcLengthTable::clear() noexcept { m_lengths.clear(); }
+
+bool gk::geometry::ArcLengthTable::empty() const noexcept { return m_lengths.empty(); }
+
+float gk::geometry::ArcLengthTable::length() const noexcept {
+  return m_lengths.empty() ? 0.0f : m_lengths.back();
+}
+
+float gk::geometry::ArcLengthTable::parameter(float distance) const noexcept {
+  if (m_lengths.size() < 2 || distance <= 0.0f) return 0.0f;
+  if (distance >= m_lengths.back()) return 1.0f;
+
+  // first sample beyond the distance, the parameter is interpolated inside the chord before it
+  auto upper = std::upper_bound(m_lengths.begin(), m_lengths.end(), distance);
+  size_t i = std::distance(m_lengths.begin(), upper) - 1;
+  float chord = m_lengths[i + 1] - m_lengths[i];
+  float local = chord > 0.0f ? (distance - m_lengths[i]) / chord : 0.0f;
+  return (float(i) + local) / float(m_lengths.size() - 1);
+}
+
+void gk::geometry::ArcLengthTable::parameters(std::span<float> out) const noexcept {
+  if (out.empty()) return;
+  if (m_lengths.size() < 2 || out.size() == 1) {
+    std::fill(out.begin(), out.end(), 0.0f);
+    return;
+  }
+
+  const float step = m_lengths.back() / float(out.size() - 1);
+  const float chords = float(m_lengths.size() - 1);
+  size_t i = 0;
+  for (size_t k = 0; k + 1 < out.size(); ++k) {
+    const float distance = step * float(k);
+    while (i + 2 < m_lengths.size() && m_lengths[i + 1] <= distance) {
+      ++i;
+    }
+    float chord = m_lengths[i + 1] - m_lengths[i];
+    float local = chord > 0.0f ? std::clamp((distance - m_lengths[i]) / chord, 0.0f, 1.0f) : 0.0f;
+    out[k] = (float(i) + local) / chords;
+  }
+  out.back() = 1.0f;
+}
+
+std::array<float, 4> gk::geometry::CubicBezierBasis::weights(float t) { return bernstein<4>(t); }
+
+std::array<float, 4> gk::geometry::CubicBezierBasis::derivatives(float t) {
+  return bernsteinDerivative<4>(t);
+}
+
+std::array<float, 4> gk::geometry::CubicBSplineBasis::weights(float t) {
+  const float t2 = t * t;
+  const float t3 = t2 * t;
+  const float s = 1.0f - t;
+  return {s * s * s / 6.0f, (3.0f * t3 - 6.0f * t2 + 4.0f) / 6.0f,
+          (-3.0f * t3 + 3.0f * t2 + 3.0f * t + 1.0f) / 6.0f, t3 / 6.0f};
+}
+
+std::array<float, 4> gk::geometry::CubicBSplineBasis::derivatives(float t) {
+  const float t2 = t * t;
+  const float s = 1.0f - t;
+  return {-s * s / 2.0f, (3.0f * t2 - 4.0f * t) / 2.0f, (-3.0f * t2 + 2.0f * t + 1.0f) / 2.0f,
+          t2 / 2.0f};
+}
@@ -1,17 +1,25 @@
 #include "Rendering/Renderer.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <vector>
 
 #include "GFX/FlyingCamera.hpp"
+#include "Geometry/Bounds.hpp"
 #include "Rendering/Scene.hpp"
 #include "Rendering/SceneNodes.hpp"
 
 namespace gk::rendering {
 
+namespace {
+// room for 4096 matrices per frame before the buffer grows
+constexpr size_t kBonePaletteSize = 4096 * sizeof(glm::mat4);
+}  // namespace
+
 Renderer::Renderer(std::shared_ptr<io::RessourceManager> assetManager)
-    : m_ressourceManager(assetManager) {
+    : m_ressourceManager(assetManager),
+      m_bonePalettes(GL_SHADER_STORAGE_BUFFER, kBonePaletteSize) {
   std::cerr << "Loaded OpenGL " << glGetString(GL_VERSION) << std::endl;
 
   glEnable(GL_DEPTH_TEST);
@@ -24,39 +32,7 @@ Renderer::Renderer(std::shared_ptr<io::RessourceManager> assetManager)
   m_aspectRatio = 0.0f;
 }
 
-std::vector<LightNode*> getLights(SceneNode* node) {
-  std::vector<LightNode*> lights;
-  for (auto child : node->children()) {
-    if (child->nodeType() == NodeType::eLight) {
-      auto lightnode = dynamic_cast<LightNode*>(child);
-      lights.push_back(lightnode);
-    }
-  }
-  return lights;
-}
-
-void Renderer::renderNode(SceneNode* node, const glm::mat4& projection,
-                          gfx::FlyingCamera& camera, std::vector<LightNode*> lights) const {
-  switch (node->nodeType()) {
-    case NodeType::eGeneric: {
-      auto groupLights = getLights(node);
-      lights.insert(lights.end(), groupLights.begin(), groupLights.end());
-      for (auto child : node->children()) {
-        renderNode(child, projection, camera, lights);
-      }
-      break;
-    }
-    case NodeType::eMesh: {
-      auto mesh = dynamic_cast<MeshNode*>(node);
-      mesh->draw(projection, camera.getViewMatrix(), camera.position(), lights);
-      break;
-    }
-    default:
-      break;
-  }
-}
-
-void Renderer::renderScene() const {
+void Renderer::renderScene() {
   glClearColor(0.1, 0.1, 0.1, 1.0);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -65,10 +41,25 @@ void Renderer::renderScene() const {
     auto& camera = (*activeCam)->camera();
     glm::mat4 projection =
         glm::perspective(glm::radians(camera.fov()), m_aspectRatio, 0.5f, 1000.0f);
-    renderNode(m_scene.root(), projection, camera);
+    const glm::mat4 view = camera.getViewMatrix();
+    m_scene.updateTransforms();
+    const auto drawList = m_scene.drawList();
+    m_scene.cull(geometry::Frustum(projection * view), m_visible);
+    // in draw list order, the BVH reports the items in no particular order
+    std::sort(m_visible.begin(), m_visible.end());
+    for (uint32_t index : m_visible) {
+      const DrawItem& item = drawList[index];
+      item.mesh->draw(item, projection, view, camera.position(), m_bonePalettes);
+    }
+    m_statistics = {m_visible.size(), drawList.size() - m_visible.size()};
+  } else {
+    m_statistics = {};
   }
+  m_bonePalettes.nextFrame();
 }
 
+const RenderStatistics& Renderer::statistics() const noexcept { return m_statistics; }
+
 Scene& Renderer::getScene() { return m_scene; }
 
 const Scene& Renderer::getScene() const { return m_scene; }
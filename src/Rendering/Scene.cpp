@@ -4,111 +4,333 @@
 
 #include "Rendering/Scene.hpp"
 
+#include <algorithm>
 #include <memory>
+#include <type_traits>
 #include <utility>
 
+#include "Animation/SkinnedMesh.hpp"
 #include "GFX/FlyingCamera.hpp"
 #include "GFX/PointLight.hpp"
 #include "Rendering/SceneNodes.hpp"
 
 namespace gk::rendering {
-Scene::Scene() {
-  auto rootNode = std::make_unique<SceneNode>(0);
-  m_rootNode = rootNode.get();
-  m_nodes[0] = std::move(rootNode);
+
+namespace {
+
+// Looks the handle up in the store of its type, SceneScope is Scene or const Scene
+template <typename SceneScope>
+auto resolve(SceneScope& scene, NodeHandle handle) noexcept {
+  using Base = std::conditional_t<std::is_const_v<SceneScope>, const SceneNode, SceneNode>;
+  Base* node = nullptr;
+  switch (handle.type) {
+    case NodeType::eGeneric:
+      node = scene.template get<SceneNode>(handle);
+      break;
+    case NodeType::eMesh:
+      node = scene.template get<MeshNode>(handle);
+      break;
+    case NodeType::eTexture:
+      node = scene.template get<TextureNode>(handle);
+      break;
+    case NodeType::eMaterial:
+      node = scene.template get<MaterialNode>(handle);
+      break;
+    case NodeType::eMaterialParams:
+      node = scene.template get<MaterialParameterNode>(handle);
+      break;
+    case NodeType::eCamera:
+      node = scene.template get<CameraNode>(handle);
+      break;
+    case NodeType::eLight:
+      node = scene.template get<LightNode>(handle);
+      break;
+  }
+  return node ? std::optional<Base*>(node) : std::nullopt;
+}
+
+// Box of a draw item in world space. The skinning matrices of a skinned mesh change without the
+// scene knowing, its bind box is moved with them at every update.
+geometry::AABB worldBounds(const DrawItem& item) {
+  geometry::AABB bounds = item.mesh->bounds();
+  if (item.mesh->skinned() && item.parameters && item.parameters->parameters()) {
+    bounds = animation::skinnedBounds(bounds, item.parameters->parameters()->skinningMatrices());
+  }
+  return bounds.transformed(*item.world);
+}
+
+}  // namespace
+
+Scene::Scene() { m_root = emplace<SceneNode>(); }
+
+std::optional<SceneNode*> Scene::getNode(NodeHandle handle) noexcept {
+  return resolve(*this, handle);
+}
+
+std::optional<const SceneNode*> Scene::getNode(NodeHandle handle) const noexcept {
+  return resolve(*this, handle);
 }
 
-std::optional<SceneNode*> Scene::getNode(long id) const noexcept {
-  if (auto node = m_nodes.find(id); node != m_nodes.end()) {
-    return node->second.get();
+std::optional<CameraNode*> Scene::activeCamera() {
+  if (auto camera = get<CameraNode>(m_activeCamera)) {
+    return camera;
   }
   return {};
 }
 
-std::optional<CameraNode*> Scene::activeCamera() const { return m_activeCamera; }
+std::optional<const CameraNode*> Scene::activeCamera() const {
+  if (auto camera = get<CameraNode>(m_activeCamera)) {
+    return camera;
+  }
+  return {};
+}
 
-void Scene::setActiveCamera(long id) {
-  if (auto node = getNode(id); node.has_value()) {
-    auto camera = dynamic_cast<CameraNode*>(*node);
-    if (camera) {
-      m_activeCamera = camera;
-    }
+void Scene::setActiveCamera(NodeHandle handle) {
+  if (get<CameraNode>(handle)) {
+    m_activeCamera = handle;
   }
 }
 
-long Scene::addNode() noexcept {
-  auto node = std::make_unique<SceneNode>(m_counter);
-  m_nodes[m_counter] = std::move(node);
-  return m_counter++;
+size_t Scene::size() const noexcept {
+  return std::apply([](const auto&... stores) { return (stores.size() + ...); }, m_stores);
 }
 
-long Scene::addCamera(gfx::FlyingCamera&& camera) {
-  auto node = std::make_unique<CameraNode>(m_counter, std::move(camera));
-  m_nodes[m_counter] = std::move(node);
-  return m_counter++;
+NodeHandle Scene::addNode() { return emplace<SceneNode>(); }
+
+NodeHandle Scene::addCamera(gfx::FlyingCamera&& camera) {
+  return emplace<CameraNode>(std::move(camera));
 }
 
-long Scene::addLight(gfx::PointLight&& light, const glm::vec3& position) {
-  auto node = std::make_unique<LightNode>(m_counter, std::move(light), position);
-  m_nodes[m_counter] = std::move(node);
-  return m_counter++;
+NodeHandle Scene::addLight(gfx::PointLight&& light, const glm::vec3& position) {
+  return emplace<LightNode>(std::move(light), position);
 }
 
-long Scene::addMaterial(gfx::Material&& material) {
-  auto node = std::make_unique<MaterialNode>(m_counter, std::move(material));
-  m_nodes[m_counter] = std::move(node);
-  return m_counter++;
+NodeHandle Scene::addMaterial(gfx::Material&& material) {
+  return emplace<MaterialNode>(std::move(material));
 }
 
-long Scene::addMaterialParameter(std::unique_ptr<gfx::MaterialParameters>&& material) {
-  auto node = std::make_unique<MaterialParameterNode>(m_counter, std::move(material));
-  m_nodes[m_counter] = std::move(node);
-  return m_counter++;
+NodeHandle Scene::addMaterialParameter(std::unique_ptr<gfx::MaterialParameters>&& material) {
+  return emplace<MaterialParameterNode>(std::move(material));
 }
 
-long Scene::addTexture(const std::span<std::byte> texture, int width, int height) {
-  auto texNode = std::make_unique<TextureNode>(m_counter, texture, width, height);
-  m_nodes[m_counter] = std::move(texNode);
-  return m_counter++;
+NodeHandle Scene::addTexture(const std::span<std::byte> texture, int width, int height) {
+  return emplace<TextureNode>(texture, width, height);
 }
 
-std::optional<long> Scene::addMesh(const gk::geometry::Mesh& mesh, long materialId) {
-  auto materialNode = getNode(materialId);
-  if (materialNode.has_value()) {
-    auto material = dynamic_cast<MaterialNode*>(*materialNode);
-    if (material) {
-      auto meshNode = std::make_unique<MeshNode>(m_counter, mesh, material);
-      m_nodes[m_counter] = std::move(meshNode);
-      return m_counter++;
-    }
+template <typename Mesh>
+std::optional<NodeHandle> Scene::emplaceMesh(const Mesh& mesh, NodeHandle material,
+                                             gfx::gl::BufferUsage usage) {
+  auto materialNode = get<MaterialNode>(material);
+  if (!materialNode) {
+    return {};
+  }
+  if constexpr (std::is_same_v<Mesh, geometry::Mesh>) {
+    return emplace<MeshNode>(mesh, *materialNode, usage);
+  } else {
+    return emplace<MeshNode>(mesh, *materialNode);
+  }
+}
+
+std::optional<NodeHandle> Scene::addMesh(const gk::geometry::Mesh& mesh, NodeHandle material,
+                                         gfx::gl::BufferUsage usage) {
+  return emplaceMesh(mesh, material, usage);
+}
+
+std::optional<NodeHandle> Scene::addMesh(const gk::animation::SkinnedMesh& mesh,
+                                         NodeHandle material) {
+  return emplaceMesh(mesh, material, gfx::gl::STATIC);
+}
+
+std::optional<NodeHandle> Scene::addMesh(const gk::animation::SkinnedMesh8& mesh,
+                                         NodeHandle material) {
+  return emplaceMesh(mesh, material, gfx::gl::STATIC);
+}
+
+std::optional<NodeHandle> Scene::addMesh(const gk::animation::SkinnedMesh16& mesh,
+                                         NodeHandle material) {
+  return emplaceMesh(mesh, material, gfx::gl::STATIC);
+}
+
+void Scene::connect(NodeHandle parentHandle, NodeHandle childHandle) {
+  auto parent = getNode(parentHandle);
+  if (parent.has_value() && getNode(childHandle).has_value()) {
+    (*parent)->connect(childHandle);
+    m_graphDirty = true;
   }
-  return {};
 }
 
-std::optional<long> Scene::addMesh(const gk::animation::SkinnedMesh& mesh, long materialId) {
-  auto materialNode = getNode(materialId);
-  if (materialNode.has_value()) {
-    auto material = dynamic_cast<MaterialNode*>(*materialNode);
-    if (material) {
-      auto meshNode = std::make_unique<MeshNode>(m_counter, mesh, material);
-      m_nodes[m_counter] = std::move(meshNode);
-      return m_counter++;
+void Scene::disconnect(NodeHandle parentHandle, NodeHandle childHandle) {
+  if (auto parent = getNode(parentHandle); parent.has_value()) {
+    (*parent)->disconnect(childHandle);
+    m_graphDirty = true;
+  }
+}
+
+bool Scene::remove(NodeHandle handle) {
+  if (handle == m_root) {
+    return false;
+  }
+  m_graphDirty = true;
+  switch (handle.type) {
+    case NodeType::eGeneric:
+      return store<SceneNode>().erase(handle.slot);
+    case NodeType::eMesh:
+      return store<MeshNode>().erase(handle.slot);
+    case NodeType::eTexture:
+      return store<TextureNode>().erase(handle.slot);
+    case NodeType::eMaterial:
+      return store<MaterialNode>().erase(handle.slot);
+    case NodeType::eMaterialParams:
+      return store<MaterialParameterNode>().erase(handle.slot);
+    case NodeType::eCamera:
+      return store<CameraNode>().erase(handle.slot);
+    case NodeType::eLight:
+      return store<LightNode>().erase(handle.slot);
+  }
+  return false;
+}
+
+NodeHandle Scene::root() const noexcept { return m_root; }
+
+std::span<const DrawItem> Scene::drawList() {
+  if (m_graphDirty) {
+    compile();
+  }
+  return m_drawItems;
+}
+
+void Scene::updateTransforms() {
+  if (m_graphDirty) {
+    compile();
+    return;
+  }
+  computeWorlds(false);
+  for (size_t i = 0; i < m_drawItems.size(); ++i) {
+    DrawState& state = m_drawStates[i];
+    const MeshNode& mesh = *m_drawItems[i].mesh;
+    if (!mesh.skinned() && !m_worldChanged[state.transform] &&
+        state.boundsVersion == mesh.boundsVersion()) {
+      continue;
     }
+    state.boundsVersion = mesh.boundsVersion();
+    m_bounds.update(state.leaf, worldBounds(m_drawItems[i]));
   }
-  return {};
 }
 
-void Scene::connect(long parentId, long childId) {
-  auto parent = getNode(parentId);
-  auto child = getNode(childId);
+void Scene::cull(const geometry::Frustum& frustum, std::vector<uint32_t>& visible) const {
+  visible.clear();
+  m_bounds.query(frustum, [&visible](uint32_t item) { visible.push_back(item); });
+}
 
-  if (parent.has_value() && child.has_value()) {
-    (*parent)->connect(*child);
+void Scene::compile() {
+  m_transforms.clear();
+  m_drawItems.clear();
+  m_drawStates.clear();
+  m_drawTextures.clear();
+  m_drawLights.clear();
+  m_drawLightTransforms.clear();
+  m_bounds.clear();
+  if (auto root = get<SceneNode>(m_root)) {
+    m_transforms.push_back({root, NodeType::eGeneric, Transform::kNoParent,
+                            root->transformVersion(), 0, 0});
+  }
+  // the groups append their children, the array is its own queue
+  for (uint32_t i = 0; i < m_transforms.size(); ++i) {
+    if (m_transforms[i].type == NodeType::eGeneric) {
+      compileGroup(i);
+    }
   }
+
+  m_worlds.resize(m_transforms.size());
+  m_worldChanged.resize(m_transforms.size());
+  computeWorlds(true);
+  // the arrays are complete, nothing moves them anymore
+  for (size_t i = 0; i < m_drawLights.size(); ++i) {
+    m_drawLights[i].world = &m_worlds[m_drawLightTransforms[i]];
+  }
+  m_bounds.reserve(m_drawItems.size());
+  for (size_t i = 0; i < m_drawItems.size(); ++i) {
+    DrawItem& item = m_drawItems[i];
+    DrawState& state = m_drawStates[i];
+    item.textures = std::span(m_drawTextures).subspan(state.firstTexture, state.textureCount);
+    item.lights = std::span(m_drawLights).subspan(state.firstLight, state.lightCount);
+    item.world = &m_worlds[state.transform];
+    state.boundsVersion = item.mesh->boundsVersion();
+    state.leaf = m_bounds.insert(worldBounds(item), uint32_t(i));
+  }
+  m_graphDirty = false;
 }
 
+void Scene::compileGroup(uint32_t group) {
+  const auto children = m_transforms[group].node->children();
+  uint32_t firstLight = m_transforms[group].firstLight;
+  uint32_t lightCount = m_transforms[group].lightCount;
+
+  // a group with lights gets its own copy of the lights above followed by its lights
+  const bool hasLights = std::ranges::any_of(children, [this](NodeHandle handle) {
+    return get<LightNode>(handle) != nullptr;
+  });
+  if (hasLights) {
+    const auto first = uint32_t(m_drawLights.size());
+    for (uint32_t i = 0; i < lightCount; ++i) {
+      const DrawLight light = m_drawLights[firstLight + i];
+      const uint32_t transform = m_drawLightTransforms[firstLight + i];
+      m_drawLights.push_back(light);
+      m_drawLightTransforms.push_back(transform);
+    }
+    for (auto handle : children) {
+      if (auto light = get<LightNode>(handle)) {
+        m_drawLights.push_back({light, nullptr});
+        m_drawLightTransforms.push_back(uint32_t(m_transforms.size()));
+        m_transforms.push_back({light, NodeType::eLight, group, light->transformVersion(), 0, 0});
+      }
+    }
+    firstLight = first;
+    lightCount = uint32_t(m_drawLights.size()) - first;
+  }
 
-SceneNode* Scene::root() const { return m_rootNode; }
-long Scene::rootId() const { return m_rootNode->id(); }
+  for (auto handle : children) {
+    if (auto subgroup = get<SceneNode>(handle)) {
+      m_transforms.push_back({subgroup, NodeType::eGeneric, group, subgroup->transformVersion(),
+                              firstLight, lightCount});
+      continue;
+    }
+    auto mesh = get<MeshNode>(handle);
+    if (!mesh) continue;
+    const auto transform = uint32_t(m_transforms.size());
+    m_transforms.push_back({mesh, NodeType::eMesh, group, mesh->transformVersion(), 0, 0});
+    // nothing is drawn without a material
+    auto material = get<MaterialNode>(mesh->material());
+    if (!material) continue;
+
+    const auto firstTexture = uint32_t(m_drawTextures.size());
+    for (auto texture : mesh->textures()) {
+      if (auto node = get<TextureNode>(texture)) {
+        m_drawTextures.push_back(node);
+      }
+    }
+    m_drawItems.push_back(
+        {mesh, material, get<MaterialParameterNode>(mesh->parameters()), {}, {}, nullptr});
+    m_drawStates.push_back({firstTexture, uint32_t(m_drawTextures.size()) - firstTexture,
+                            firstLight, lightCount, transform, geometry::DynamicBVH::kNull, 0});
+  }
+}
+
+void Scene::computeWorlds(bool all) {
+  // parents are computed first, a node is recomputed when its local transform or the world
+  // transform of its parent changed
+  for (size_t i = 0; i < m_transforms.size(); ++i) {
+    Transform& transform = m_transforms[i];
+    const uint32_t version = transform.node->transformVersion();
+    const bool hasParent = transform.parent != Transform::kNoParent;
+    const bool changed =
+        all || version != transform.version || (hasParent && m_worldChanged[transform.parent]);
+    m_worldChanged[i] = changed;
+    if (!changed) continue;
+    transform.version = version;
+    const glm::mat4& local = transform.node->localTransform();
+    m_worlds[i] = hasParent ? m_worlds[transform.parent] * local : local;
+  }
+}
 
 }  // namespace gk::rendering
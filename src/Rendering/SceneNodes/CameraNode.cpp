@@ -6,12 +6,10 @@
 
 namespace gk::rendering {
 
-CameraNode::CameraNode(long id, gfx::FlyingCamera&& cam) : SceneNode(id) {
+CameraNode::CameraNode(gfx::FlyingCamera&& cam) {
     m_camera = std::make_unique<gfx::FlyingCamera>(std::move(cam));
 }
 
-NodeType CameraNode::nodeType() const { return NodeType::eCamera; };
-
 const gfx::FlyingCamera& CameraNode::camera() const { return *m_camera; }
 
 gfx::FlyingCamera& CameraNode::camera() { return *m_camera; }
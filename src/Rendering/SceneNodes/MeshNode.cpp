@@ -2,9 +2,13 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <memory>
 #include <span>
+#include <string>
 #include <vector>
 
 #include "GFX/OpenGL/GLMesh.hpp"
@@ -13,33 +17,118 @@
 
 namespace gk::rendering {
 
-MeshNode::MeshNode(long id, const gk::geometry::Mesh& mesh, MaterialNode* material)
-    : SceneNode(id) {
-  auto& program = material->program();
+namespace {
+
+// Layout of the packed skinned vertices, bone indices are read as integers and weights as
+// normalised floats
+template <typename Weight>
+std::array<gfx::gl::VertexFormat, 5> packedSkinnedFormats() {
+  using Vertex = typename animation::PackedSkinnedMesh<Weight>::Vertex;
+  constexpr GLenum weightType = sizeof(Weight) == 1 ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT;
+  return {{{0, 3, GL_FLOAT, GL_FALSE, false, offsetof(Vertex, position)},
+           {1, 3, GL_FLOAT, GL_FALSE, false, offsetof(Vertex, normal)},
+           {2, 2, GL_FLOAT, GL_FALSE, false, offsetof(Vertex, uv)},
+           {3, 4, GL_UNSIGNED_BYTE, GL_FALSE, true, offsetof(Vertex, boneIdx)},
+           {4, 4, weightType, GL_TRUE, false, offsetof(Vertex, boneWeights)}}};
+}
+
+template <typename Weight>
+std::unique_ptr<gfx::gl::Mesh> makePackedMesh(const animation::PackedSkinnedMesh<Weight>& mesh,
+                                              const gfx::gl::ShaderProgram& program) {
+  using Vertex = typename animation::PackedSkinnedMesh<Weight>::Vertex;
+  const auto formats = packedSkinnedFormats<Weight>();
+  return std::make_unique<gfx::gl::Mesh>(std::span<const Vertex>{mesh.vertices},
+                                         std::span<const uint>{mesh.indices}, program,
+                                         std::span<const gfx::gl::VertexFormat>{formats});
+}
+
+// MAX_POINTS_LIGHTS of the shaders
+constexpr size_t kMaxPointLights = 10;
+
+struct PointLightUniforms {
+  std::string color, intensity, range, decay, position;
+};
+
+// Built once so that setting the lights does not format names every draw
+const std::array<PointLightUniforms, kMaxPointLights>& pointLightUniforms() {
+  static const auto uniforms = [] {
+    std::array<PointLightUniforms, kMaxPointLights> names;
+    for (size_t i = 0; i < kMaxPointLights; ++i) {
+      const std::string light = "pointLights[" + std::to_string(i) + "].";
+      names[i] = {light + "color", light + "intensity", light + "range", light + "decay",
+                  light + "position"};
+    }
+    return names;
+  }();
+  return uniforms;
+}
+
+}  // namespace
+
+MeshNode::MeshNode(const gk::geometry::Mesh& mesh, const MaterialNode& material,
+                   gfx::gl::BufferUsage usage)
+    : m_bounds(geometry::computeBounds(std::span{mesh.vertices})) {
+  auto& program = material.program();
   m_mesh = std::make_unique<gfx::gl::Mesh>(std::span<const geometry::Mesh::Vertex>{mesh.vertices},
-                                           std::span<const uint>{mesh.indices}, program);
+                                           std::span<const uint>{mesh.indices}, program,
+                                           gfx::gl::TRIANGLES, usage);
 }
 
-MeshNode::MeshNode(long id, const gk::animation::SkinnedMesh& mesh, MaterialNode* material)
-    : SceneNode(id) {
-  auto& program = material->program();
+MeshNode::MeshNode(const gk::animation::SkinnedMesh& mesh, const MaterialNode& material)
+    : m_bounds(geometry::computeBounds(std::span{mesh.vertices})), m_skinned(true) {
+  auto& program = material.program();
   m_mesh = std::make_unique<gfx::gl::Mesh>(
       std::span<const animation::SkinnedMesh::Vertex>{mesh.vertices},
       std::span<const uint>{mesh.indices}, program);
 }
 
-void MeshNode::draw(const glm::mat4& projection_matrix, const glm::mat4& view_matrix,
-                    const glm::vec3& cameraPosition, const std::vector<LightNode*> lights) const {
+MeshNode::MeshNode(const gk::animation::SkinnedMesh8& mesh, const MaterialNode& material)
+    : m_bounds(geometry::computeBounds(std::span{mesh.vertices})), m_skinned(true) {
+  m_mesh = makePackedMesh(mesh, material.program());
+}
+
+MeshNode::MeshNode(const gk::animation::SkinnedMesh16& mesh, const MaterialNode& material)
+    : m_bounds(geometry::computeBounds(std::span{mesh.vertices})), m_skinned(true) {
+  m_mesh = makePackedMesh(mesh, material.program());
+}
+
+void MeshNode::update(const gk::geometry::Mesh& mesh) {
+  m_mesh->update(std::span<const geometry::Mesh::Vertex>{mesh.vertices},
+                 std::span<const uint>{mesh.indices});
+  setBounds(geometry::computeBounds(std::span{mesh.vertices}));
+}
+
+void MeshNode::update(const gk::geometry::Mesh& mesh, gk::geometry::VertexRange range) {
+  const auto vertices =
+      std::span<const geometry::Mesh::Vertex>{mesh.vertices}.subspan(range.offset, range.count);
+  m_mesh->update(vertices, range.offset);
+  // the other vertices are not read again, the bounds can only grow
+  setBounds(geometry::merge(m_bounds, geometry::computeBounds(vertices)));
+}
+
+void MeshNode::update(std::span<const gk::geometry::Mesh::Vertex> vertices) {
+  m_mesh->update(vertices);
+  setBounds(geometry::computeBounds(vertices));
+}
+
+void MeshNode::draw(const DrawItem& item, const glm::mat4& projection_matrix,
+                    const glm::mat4& view_matrix, const glm::vec3& cameraPosition,
+                    gfx::gl::RingBuffer& bonePalettes) const {
+  if (!item.material) {
+    return;
+  }
   m_mesh->bind();
-  auto& program = m_material->program();
+  auto& program = item.material->program();
   program.use();
   program.setUniform("projection", projection_matrix);
   program.setUniform("view", view_matrix);
-  program.setUniform("model", m_modelMatrix);
+  const glm::mat4& model = *item.world;
+  program.setUniform("model", model);
+  program.setUniform("normal_matrix", glm::mat3(glm::transpose(glm::inverse(model))));
   program.setUniform("view_pos", cameraPosition);
 
-  if (m_params) {
-    auto parameters = m_params->parameters();
+  if (item.parameters) {
+    auto parameters = item.parameters->parameters();
 
     for (auto& param : parameters->boolParameters()) {
       program.setUniform(param.first, param.second);
@@ -65,49 +154,48 @@ void MeshNode::draw(const glm::mat4& projection_matrix, const glm::mat4& view_ma
     for (auto& param : parameters->mat4Parameters()) {
       program.setUniform(param.first, param.second);
     }
+    if (auto palette = parameters->bonePalette(); !palette.empty()) {
+      bonePalettes.bindRange(gfx::kBonePaletteBinding, bonePalettes.write(palette));
+    }
   }
 
-  // TODO: better light management
-  program.setUniform("nb_point_lights", static_cast<glm::int32>(lights.size()));
-  for (int i = 0; i < int(lights.size()); i++) {
-    auto& light = lights[i]->light();
-    program.setUniform("pointLights[" + std::to_string(i) + "].color", light.color);
-    program.setUniform("pointLights[" + std::to_string(i) + "].intensity", light.intensity);
-    program.setUniform("pointLights[" + std::to_string(i) + "].range", light.range);
-    program.setUniform("pointLights[" + std::to_string(i) + "].decay", light.decay);
-    program.setUniform("pointLights[" + std::to_string(i) + "].position", lights[i]->position());
+  const size_t lightCount = std::min(item.lights.size(), kMaxPointLights);
+  const auto& uniforms = pointLightUniforms();
+  program.setUniform("nb_point_lights", static_cast<glm::int32>(lightCount));
+  for (size_t i = 0; i < lightCount; i++) {
+    const auto& [node, world] = item.lights[i];
+    auto& light = node->light();
+    program.setUniform(uniforms[i].color, light.color);
+    program.setUniform(uniforms[i].intensity, light.intensity);
+    program.setUniform(uniforms[i].range, light.range);
+    program.setUniform(uniforms[i].decay, light.decay);
+    program.setUniform(uniforms[i].position, glm::vec3(*world * glm::vec4(node->position(), 1.0f)));
   }
 
-  if (!m_textures.empty()) {
+  if (!item.textures.empty()) {
     program.setUniform("hasTex", static_cast<glm::int32>(true));
   }
 
-  for (auto& tex : m_textures) {
+  for (auto tex : item.textures) {
     tex->bind();
   }
   m_mesh->draw();
 }
 
-void MeshNode::connect(SceneNode* node) noexcept {
-  switch (node->nodeType()) {
-    case NodeType::eMaterial: {
-      auto materialNode = dynamic_cast<MaterialNode*>(node);
-      m_material = materialNode;
+void MeshNode::connect(NodeHandle node) noexcept {
+  switch (node.type) {
+    case NodeType::eMaterial:
+      m_material = node;
       m_children.push_back(node);
       break;
-    }
-    case NodeType::eMaterialParams: {
-      auto paramsNode = dynamic_cast<MaterialParameterNode*>(node);
-      m_params = paramsNode;
+    case NodeType::eMaterialParams:
+      m_params = node;
       m_children.push_back(node);
       break;
-    }
-    case NodeType::eTexture: {
-      auto textureNode = dynamic_cast<TextureNode*>(node);
-      m_textures.push_back(textureNode);
+    case NodeType::eTexture:
+      m_textures.push_back(node);
       m_children.push_back(node);
       break;
-    }
     case NodeType::eMesh:
     case NodeType::eCamera:
     case NodeType::eGeneric:
@@ -116,34 +204,36 @@ void MeshNode::connect(SceneNode* node) noexcept {
   }
 }
 
-void MeshNode::disconnect(long id) noexcept {
-  if (m_material->id() == id) {
-    m_material = nullptr;
-  } else if (m_params->id() == id) {
-    m_params = nullptr;
+void MeshNode::disconnect(NodeHandle node) noexcept {
+  if (m_material == node) {
+    m_material = {};
+  } else if (m_params == node) {
+    m_params = {};
   }
-  auto tex = std::find_if(m_textures.begin(), m_textures.end(),
-                          [id](SceneNode* node) { return node->id() == id; });
-  if (tex != m_textures.end()) {
-    m_textures.erase(tex);
-  }
-  SceneNode::disconnect(id);
+  std::erase(m_textures, node);
+  SceneNode::disconnect(node);
 }
 
-void MeshNode::translate(const glm::vec3& translation) noexcept {
-  glm::translate(m_modelMatrix, translation);
-}
+NodeHandle MeshNode::material() const noexcept { return m_material; }
 
-void MeshNode::rotate(float angle, const glm::vec3& axis) noexcept {
-  glm::rotate(m_modelMatrix, angle, axis);
-}
+NodeHandle MeshNode::parameters() const noexcept { return m_params; }
+
+std::span<const NodeHandle> MeshNode::textures() const noexcept { return m_textures; }
 
-bool MeshNode::hasMaterial() const noexcept { return m_material != nullptr; }
+bool MeshNode::hasMaterial() const noexcept { return m_material != NodeHandle{}; }
 
 bool MeshNode::hasTextures() const noexcept { return !m_textures.empty(); }
 
-NodeType MeshNode::nodeType() const { return NodeType::eMesh; }
+const geometry::AABB& MeshNode::bounds() const noexcept { return m_bounds; }
+
+void MeshNode::setBounds(const geometry::AABB& bounds) noexcept {
+  if (bounds == m_bounds) return;
+  m_bounds = bounds;
+  ++m_boundsVersion;
+}
+
+uint32_t MeshNode::boundsVersion() const noexcept { return m_boundsVersion; }
 
-NodeType MaterialNode::nodeType() const { return NodeType::eMaterial; }
+bool MeshNode::skinned() const noexcept { return m_skinned; }
 
 }  // namespace gk::rendering
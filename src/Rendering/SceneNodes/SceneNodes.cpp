@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <glm/fwd.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <memory>
 
 #include "GFX/Material.hpp"
@@ -15,32 +16,40 @@
 namespace gk::rendering {
 
 // SceneNode Base class
-SceneNode::SceneNode(long id) : m_id(id) {}
+std::span<const NodeHandle> SceneNode::children() const noexcept { return m_children; }
 
-long SceneNode::id() const noexcept { return m_id; }
+void SceneNode::connect(NodeHandle node) noexcept { m_children.push_back(node); }
 
-const std::span<SceneNode* const> SceneNode::children() const noexcept { return m_children; }
-
-void SceneNode::connect(SceneNode* node) noexcept { m_children.push_back(node); }
-
-void SceneNode::disconnect(long id) noexcept {
-  auto child = std::find_if(m_children.begin(), m_children.end(),
-                            [id](SceneNode* node) { return node->id() == id; });
+void SceneNode::disconnect(NodeHandle node) noexcept {
+  auto child = std::find(m_children.begin(), m_children.end(), node);
   if (child != m_children.end()) {
     m_children.erase(child);
   }
 }
 
-NodeType SceneNode::nodeType() const { return NodeType::eGeneric; }
+const glm::mat4& SceneNode::localTransform() const noexcept { return m_localTransform; }
+
+void SceneNode::setLocalTransform(const glm::mat4& transform) noexcept {
+  m_localTransform = transform;
+  ++m_transformVersion;
+}
+
+void SceneNode::translate(const glm::vec3& translation) noexcept {
+  setLocalTransform(glm::translate(m_localTransform, translation));
+}
+
+void SceneNode::rotate(float angle, const glm::vec3& axis) noexcept {
+  setLocalTransform(glm::rotate(m_localTransform, angle, axis));
+}
+
+uint32_t SceneNode::transformVersion() const noexcept { return m_transformVersion; }
 
 // LightNode
-LightNode::LightNode(long id, gfx::PointLight&& light, const glm::vec3& position) : SceneNode(id) {
+LightNode::LightNode(gfx::PointLight&& light, const glm::vec3& position) {
   m_light = std::make_unique<gfx::PointLight>(std::move(light));
   m_position = position;
 }
 
-NodeType LightNode::nodeType() const { return NodeType::eLight; }
-
 const gfx::PointLight& LightNode::light() const { return *m_light; }
 
 gfx::PointLight& LightNode::light() { return *m_light; }
@@ -51,21 +60,17 @@ void LightNode::setPosition(const glm::vec3& position) noexcept { m_position = p
 
 // MaterialNode
 
-MaterialNode::MaterialNode(long id, gfx::Material&& material)
-    : SceneNode(id), m_material(std::move(material)) {}
+MaterialNode::MaterialNode(gfx::Material&& material) : m_material(std::move(material)) {}
 
 gfx::gl::ShaderProgram& MaterialNode::program() const noexcept { return m_material.program(); }
 
 // MaterialParameters
-MaterialParameterNode::MaterialParameterNode(long id) : SceneNode(id) {
+MaterialParameterNode::MaterialParameterNode() {
   m_parameters = std::make_unique<gfx::MockParameters>();
 }
 
-MaterialParameterNode::MaterialParameterNode(long id,
-                                             std::unique_ptr<gfx::MaterialParameters>&& parameters)
-    : SceneNode(id), m_parameters(std::move(parameters)) {}
-
-NodeType MaterialParameterNode::nodeType() const { return NodeType::eMaterialParams; }
+MaterialParameterNode::MaterialParameterNode(std::unique_ptr<gfx::MaterialParameters>&& parameters)
+    : m_parameters(std::move(parameters)) {}
 
 const gfx::MaterialParameters* MaterialParameterNode::parameters() const { return m_parameters.get(); }
 gfx::MaterialParameters* MaterialParameterNode::parameters() { return m_parameters.get(); }
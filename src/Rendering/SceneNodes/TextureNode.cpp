@@ -9,8 +9,7 @@
 
 namespace gk::rendering {
 
-TextureNode::TextureNode(long id, const std::span<std::byte> texture, int width, int height)
-    : SceneNode(id) {
+TextureNode::TextureNode(const std::span<std::byte> texture, int width, int height) {
   m_tex = std::make_unique<gfx::gl::Texture>(texture, width, height);
 }
 
@@ -18,9 +17,7 @@ void TextureNode::update(const std::span<std::byte> texture, int width, int heig
   m_tex = std::make_unique<gfx::gl::Texture>(texture, width, height);
 }
 
-void TextureNode::bind() noexcept { m_tex->bind(); }
-
-NodeType TextureNode::nodeType() const { return NodeType::eTexture; }
+void TextureNode::bind() const noexcept { m_tex->bind(); }
 
 const gfx::gl::Texture& TextureNode::texture() const noexcept { return *m_tex; }
 }  // namespace gk::rendering
@@ -0,0 +1,131 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <glm/glm.hpp>
+#include <utility>
+
+#include "Geometry/Surface.hpp"
+
+namespace {
+
+int failures = 0;
+
+// Not assert, the tests also run in Release
+#define CHECK(condition)                                                          \
+  do {                                                                            \
+    if (!(condition)) {                                                           \
+      std::printf("%s:%d: %s failed\n", __FILE__, __LINE__, #condition);          \
+      ++failures;                                                                 \
+    }                                                                             \
+  } while (false)
+
+std::array<glm::vec3, 16> ctrlGrid() {
+  std::array<glm::vec3, 16> grid;
+  for (size_t i = 0; i < 4; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      grid[i * 4 + j] = glm::vec3(float(i), (i + j) % 2 ? 1.0f : -1.0f, float(j));
+    }
+  }
+  return grid;
+}
+
+// Setting the same number of edges again must reuse the buffers of the mesh
+void repeatedEdges() {
+  constexpr size_t edges = 32;
+  gk::geometry::BezierSurface<4, 4> surface(ctrlGrid(), edges);
+  const auto& mesh = surface.mesh();
+  const size_t vertexCount = mesh.vertices.size();
+  const size_t indexCount = mesh.indices.size();
+  CHECK(vertexCount == edges * edges);
+  CHECK(indexCount == (edges - 1) * (edges - 1) * 6);
+
+  const size_t vertexCapacity = mesh.vertices.capacity();
+  const size_t indexCapacity = mesh.indices.capacity();
+  const auto* vertices = mesh.vertices.data();
+  const auto* indices = mesh.indices.data();
+  for (int i = 0; i < 100; ++i) {
+    surface.setMeshEdges(edges);
+    CHECK(mesh.vertices.size() == vertexCount);
+    CHECK(mesh.indices.size() == indexCount);
+    CHECK(mesh.vertices.capacity() == vertexCapacity);
+    CHECK(mesh.indices.capacity() == indexCapacity);
+    CHECK(mesh.vertices.data() == vertices);
+    CHECK(mesh.indices.data() == indices);
+  }
+}
+
+// Going back to fewer edges shrinks the mesh but keeps the storage of the larger one
+void shrinkingEdges() {
+  gk::geometry::BezierSurface<4, 4> surface(ctrlGrid(), 64);
+  const auto& mesh = surface.mesh();
+  const size_t vertexCapacity = mesh.vertices.capacity();
+  const size_t indexCapacity = mesh.indices.capacity();
+  for (int i = 0; i < 10; ++i) {
+    surface.setMeshEdges(16);
+    CHECK(mesh.vertices.size() == 16 * 16);
+    CHECK(mesh.indices.size() == 15 * 15 * 6);
+    surface.setMeshEdges(64);
+    CHECK(mesh.vertices.size() == 64 * 64);
+    CHECK(mesh.indices.size() == 63 * 63 * 6);
+    CHECK(mesh.vertices.capacity() == vertexCapacity);
+    CHECK(mesh.indices.capacity() == indexCapacity);
+  }
+}
+
+// Less than two edges is raised to two, a single cell
+void tooFewEdges() {
+  gk::geometry::BezierSurface<4, 4> surface(ctrlGrid(), 8);
+  for (size_t edges : {size_t(0), size_t(1)}) {
+    surface.setMeshEdges(edges);
+    CHECK(surface.meshEdgesU() == 2);
+    CHECK(surface.meshEdgesV() == 2);
+    CHECK(surface.mesh().vertices.size() == 4);
+    CHECK(surface.mesh().indices.size() == 6);
+  }
+}
+
+// Moving a control point in place gives the mesh of the moved grid, a border point only touches
+// the rows of its border while an interior point touches nearly every row
+void movedControlPoint() {
+  constexpr size_t edges = 16;
+  gk::geometry::BezierSurface<4, 4> surface(ctrlGrid(), edges);
+  auto grid = ctrlGrid();
+  const glm::vec3 delta(0.25f, 0.5f, -0.125f);
+
+  for (auto [i, j] : {std::pair<size_t, size_t>{1, 2}, {2, 0}, {3, 3}}) {
+    const auto range = surface.moveControlPoint(i, j, delta);
+    grid[i * 4 + j] += delta;
+    if (j == 0) {
+      CHECK(range.offset == 0);
+      CHECK(range.count < edges * edges);
+    } else if (j == 3) {
+      CHECK(range.offset + range.count == edges * edges);
+      CHECK(range.count < edges * edges);
+    } else {
+      CHECK(range.count >= (edges - 2) * edges);
+    }
+
+    auto copy = grid;
+    gk::geometry::BezierSurface<4, 4> expected(std::move(copy), edges);
+    for (size_t v = 0; v < edges * edges; ++v) {
+      const auto& moved = surface.mesh().vertices[v];
+      const auto& rebuilt = expected.mesh().vertices[v];
+      CHECK(glm::length(moved.position - rebuilt.position) < 1e-4f);
+      CHECK(glm::length(moved.normal - rebuilt.normal) < 1e-3f);
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  repeatedEdges();
+  shrinkingEdges();
+  tooFewEdges();
+  movedControlPoint();
+  return failures == 0 ? 0 : 1;
+}